@@ -0,0 +1,470 @@
+#include "bounded_queue.h"
+#include "build_command.h"
+#include "export_mesh_command.h"
+#include "heightmap_io.h"
+#include "mesh_util.h"
+#include "push_constants.h"
+#include "rtin_mesh.h"
+#include "terrain_reader.h"
+#include "vk_util.h"
+
+#include <vulkan/vulkan.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+auroraterrian_bench
+
+micro: heightmap decode, u16 <-> u32, grid mesh, RTIN mesh, writeOBJ, BoundedQueue contention
+gpu:   extract_tile / downsample dispatch + readback (any Vulkan ICD, e.g. lavapipe)
+macro: build (plain and with --filter) and export_mesh end to end on a synthetic heightmap, TerrainReader sampling of the result
+
+Run it from anywhere: shaders are loaded from the build tree (AURORA_SHADER_DIR, see shaderPath in vk_util.h).
+Results go to stdout as a table and to --out as JSON or CSV so runs can be diffed over time.
+*/
+
+struct BenchArgs {
+    uint32_t size = 1024;        // synthetic heightmap is size x size (multiple of TILE)
+    uint32_t iters = 5;
+    std::string filter;          // only run benchmarks whose name contains this
+    bool gpu = true;
+    std::string format = "json"; // json | csv
+    std::string outPath;         // empty = table only
+    std::string workDir = "bench_out";
+};
+
+struct BenchResult {
+    std::string name;
+    uint32_t iters = 0;
+    double minMs = 0, meanMs = 0, maxMs = 0;
+    double items = 0;            // work per iteration (pixels, vertices, queue ops, bytes ...)
+    std::string unit;
+};
+
+using Clock = std::chrono::steady_clock;
+
+// tile size for the GPU benches and the CPU tile cutter. build's default --tile-size, which the
+// build_e2e benches use too
+static constexpr uint32_t TILE = 256;
+
+static double msSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+}
+
+static bool wanted(const BenchArgs& a, const std::string& name) {
+    return a.filter.empty() || name.find(a.filter) != std::string::npos;
+}
+
+// one warmup run then iters timed runs
+static void runBench(const BenchArgs& a, std::vector<BenchResult>& out, const std::string& name,
+                     double items, const std::string& unit, const std::function<void()>& fn) {
+    if (!wanted(a, name)) return;
+
+    fn();
+    BenchResult r;
+    r.name = name;
+    r.iters = std::max(1u, a.iters);
+    r.items = items;
+    r.unit = unit;
+    r.minMs = 1e300;
+    double total = 0;
+    for (uint32_t i = 0; i < r.iters; i++) {
+        const auto t0 = Clock::now();
+        fn();
+        const double ms = msSince(t0);
+        total += ms;
+        r.minMs = std::min(r.minMs, ms);
+        r.maxMs = std::max(r.maxMs, ms);
+    }
+    r.meanMs = total / r.iters;
+    std::cout << "  " << name << ": mean " << r.meanMs << " ms, min " << r.minMs << " ms";
+    if (items > 0) std::cout << ", " << (items / (r.meanMs / 1000.0)) << " " << unit << "/s";
+    std::cout << "\n";
+    out.push_back(r);
+}
+
+// --- synthetic data ---
+static std::vector<uint16_t> makeTerrain(uint32_t w, uint32_t h) {
+    std::vector<uint16_t> hm((size_t)w * h);
+    for (uint32_t y = 0; y < h; y++) {
+        for (uint32_t x = 0; x < w; x++) {
+            const double v = 0.5
+                + 0.25 * std::sin(x * 0.013) * std::cos(y * 0.017)
+                + 0.15 * std::sin(x * 0.031 + y * 0.023)
+                + 0.002 * std::cos(x * 0.19) * std::sin(y * 0.17);
+            hm[(size_t)y * w + x] = (uint16_t)std::clamp(v * 65535.0, 0.0, 65535.0);
+        }
+    }
+    return hm;
+}
+
+// binary 16-bit PGM (big endian), which stbi_load_16 reads like a 16-bit png
+static void writePGM16(const std::string& path, uint32_t w, uint32_t h, const std::vector<uint16_t>& px) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("Failed to write: " + path);
+    f << "P5\n" << w << " " << h << "\n65535\n";
+    std::vector<uint8_t> be(px.size() * 2);
+    for (size_t i = 0; i < px.size(); i++) {
+        be[i * 2 + 0] = (uint8_t)(px[i] >> 8);
+        be[i * 2 + 1] = (uint8_t)(px[i] & 0xFF);
+    }
+    f.write(reinterpret_cast<const char*>(be.data()), (std::streamsize)be.size());
+}
+
+// --- CPU benchmarks ---
+static void cpuBenches(const BenchArgs& a, const std::string& hmPath, const std::vector<uint16_t>& hm,
+                       std::vector<BenchResult>& out) {
+    const double pixels = (double)a.size * a.size;
+
+    runBench(a, out, "heightmap_decode", pixels, "px", [&] {
+        uint32_t w = 0, h = 0;
+        std::vector<uint16_t> px;
+        loadHeightmap16(hmPath, w, h, px);
+    });
+
+    std::vector<uint32_t> u32(hm.size());
+    std::vector<uint16_t> u16(hm.size());
+    runBench(a, out, "u16_to_u32", pixels, "px", [&] { widenU16ToU32(hm.data(), hm.size(), u32.data()); });
+    runBench(a, out, "u32_to_u16", pixels, "px", [&] { narrowU32ToU16(u32.data(), u32.size(), u16.data()); });
+
+    // one 257x257 tile (tile + borders) cut from the synthetic map
+    const uint32_t G = 257;
+    std::vector<uint16_t> tile((size_t)G * G);
+    for (uint32_t z = 0; z < G; z++)
+        for (uint32_t x = 0; x < G; x++)
+            tile[(size_t)z * G + x] = hm[(size_t)std::min(z, a.size - 1) * a.size + std::min(x, a.size - 1)];
+
+    std::vector<float> verts;
+    std::vector<uint32_t> idx;
+    runBench(a, out, "grid_mesh_tile", (double)G * G, "px", [&] {
+        buildGridMeshFromHeightU16(tile, G, 1.0f, 100.0f, 0.0f, 0.0f, verts, idx);
+    });
+
+    const RtinTriangulator rtin(G);
+    runBench(a, out, "rtin_mesh_tile_err0.5", (double)G * G, "px", [&] {
+        buildRtinMeshFromHeightU16(rtin, tile, 1.0f, 100.0f, 0.0f, 0.0f, 0.5f, verts, idx);
+    });
+
+    buildGridMeshFromHeightU16(tile, G, 1.0f, 100.0f, 0.0f, 0.0f, verts, idx);
+    const std::string objPath = a.workDir + "/bench_tile.obj";
+    runBench(a, out, "write_obj_tile", (double)verts.size() / 3, "verts", [&] { writeOBJ(objPath, verts, idx); });
+
+    // producers/consumers hammering one small queue, like jobQ / writeQ
+    const uint32_t hw = std::max(2u, std::thread::hardware_concurrency());
+    const uint32_t producers = std::max(1u, hw / 2);
+    const uint32_t consumers = std::max(1u, hw - producers);
+    const uint32_t perProducer = 200000;
+    runBench(a, out, "bounded_queue_" + std::to_string(producers) + "p" + std::to_string(consumers) + "c",
+             (double)producers * perProducer, "ops", [&] {
+        BoundedQueue<uint32_t> q(16);
+        std::vector<std::thread> th;
+        for (uint32_t p = 0; p < producers; p++)
+            th.emplace_back([&] { for (uint32_t i = 0; i < perProducer; i++) q.push(i); });
+        std::vector<std::thread> cons;
+        for (uint32_t c = 0; c < consumers; c++)
+            cons.emplace_back([&] { uint32_t v; while (q.pop(v)) {} });
+        for (auto& t : th) t.join();
+        q.close();
+        for (auto& t : cons) t.join();
+    });
+}
+
+// --- GPU benchmarks (extract_tile / downsample, same setup as build_command.cpp) ---
+static void gpuBenches(const BenchArgs& a, const VulkanContext& ctx, const std::vector<uint16_t>& hm,
+                       std::vector<BenchResult>& out) {
+    VkDevice device = ctx.device;
+    const VkMemoryPropertyFlags hostMem =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    VkDescriptorSetLayout setLayout = makeSetLayout(device);
+    VkPipelineLayout pipelineLayout = makePipelineLayout(device, setLayout, 32);
+    VkShaderModule modExtract = VK_NULL_HANDLE, modDown = VK_NULL_HANDLE;
+    VkPipeline pipeExtract = makeComputePipeline(device, pipelineLayout, shaderPath("extract_tile.comp.spv"), &modExtract);
+    VkPipeline pipeDown = makeComputePipeline(device, pipelineLayout, shaderPath("downsample.comp.spv"), &modDown);
+
+    const VkDeviceSize hmBytes = sizeof(uint32_t) * (VkDeviceSize)hm.size();
+    const VkDeviceSize tileBytes = sizeof(uint32_t) * TILE * TILE;
+    Buffer hmBuf = createBuffer(device, ctx.physicalDevice, hmBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    Buffer tileA = createBuffer(device, ctx.physicalDevice, tileBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    Buffer tileB = createBuffer(device, ctx.physicalDevice, tileBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+
+    std::vector<uint32_t> hmU32(hm.size());
+    widenU16ToU32(hm.data(), hm.size(), hmU32.data());
+    runBench(a, out, "gpu_upload_heightmap", (double)hmBytes, "bytes", [&] {
+        void* mapped = nullptr;
+        vkCheck(vkMapMemory(device, hmBuf.memory, 0, hmBytes, 0, &mapped), "vkMapMemory(heightmap)");
+        std::memcpy(mapped, hmU32.data(), (size_t)hmBytes);
+        vkUnmapMemory(device, hmBuf.memory);
+    });
+
+    VkDescriptorPoolSize ps{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 4 };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = 2;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &ps;
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    vkCheck(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descPool), "vkCreateDescriptorPool");
+
+    VkDescriptorSetLayout layouts[2] = { setLayout, setLayout };
+    VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    ai.descriptorPool = descPool;
+    ai.descriptorSetCount = 2;
+    ai.pSetLayouts = layouts;
+    VkDescriptorSet sets[2]{};
+    vkCheck(vkAllocateDescriptorSets(device, &ai, sets), "vkAllocateDescriptorSets");
+
+    auto bind2 = [&](VkDescriptorSet set, VkBuffer inB, VkDeviceSize inSize, VkBuffer outB, VkDeviceSize outSize) {
+        VkDescriptorBufferInfo inInfo{ inB, 0, inSize };
+        VkDescriptorBufferInfo outInfo{ outB, 0, outSize };
+        VkWriteDescriptorSet w[2]{};
+        for (int i = 0; i < 2; i++) {
+            w[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[i].dstSet = set;
+            w[i].dstBinding = (uint32_t)i;
+            w[i].descriptorCount = 1;
+            w[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[i].pBufferInfo = i == 0 ? &inInfo : &outInfo;
+        }
+        vkUpdateDescriptorSets(device, 2, w, 0, nullptr);
+    };
+    bind2(sets[0], hmBuf.buffer, hmBytes, tileA.buffer, tileBytes);
+    bind2(sets[1], tileA.buffer, tileBytes, tileB.buffer, tileBytes);
+
+    VkCommandPoolCreateInfo cpInfo{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    cpInfo.queueFamilyIndex = ctx.computeQueueFamily;
+    cpInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    VkCommandPool cmdPool = VK_NULL_HANDLE;
+    vkCheck(vkCreateCommandPool(device, &cpInfo, nullptr, &cmdPool), "vkCreateCommandPool");
+    VkCommandBufferAllocateInfo cbAlloc{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cbAlloc.commandPool = cmdPool;
+    cbAlloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cbAlloc.commandBufferCount = 1;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    vkCheck(vkAllocateCommandBuffers(device, &cbAlloc, &cmd), "vkAllocateCommandBuffers");
+
+    // record + submit + wait, one dispatch (what build does per tile step)
+    auto dispatch = [&](VkPipeline pipe, VkDescriptorSet set, const void* pc, uint32_t pcBytes, uint32_t size) {
+        VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        vkCheck(vkResetCommandBuffer(cmd, 0), "vkResetCommandBuffer");
+        vkCheck(vkBeginCommandBuffer(cmd, &beginInfo), "vkBeginCommandBuffer");
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipe);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &set, 0, nullptr);
+        vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, pcBytes, pc);
+        vkCmdDispatch(cmd, (size + 15) / 16, (size + 15) / 16, 1);
+        vkCheck(vkEndCommandBuffer(cmd), "vkEndCommandBuffer");
+
+        VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmd;
+        vkCheck(vkQueueSubmit(ctx.queue, 1, &submitInfo, VK_NULL_HANDLE), "vkQueueSubmit");
+        vkCheck(vkQueueWaitIdle(ctx.queue), "vkQueueWaitIdle");
+    };
+
+    PCExtract pcE{ a.size, a.size, 0, 0 };
+    runBench(a, out, "gpu_extract_tile", (double)TILE * TILE, "px", [&] {
+        dispatch(pipeExtract, sets[0], &pcE, sizeof(pcE), TILE);
+    });
+    PCDownsample pcD{ TILE };
+    runBench(a, out, "gpu_downsample_256", (double)(TILE / 2) * (TILE / 2), "px", [&] {
+        dispatch(pipeDown, sets[1], &pcD, sizeof(pcD), TILE / 2);
+    });
+
+    std::vector<uint32_t> back(TILE * TILE);
+    runBench(a, out, "gpu_readback_tile", (double)tileBytes, "bytes", [&] {
+        void* mapped = nullptr;
+        vkCheck(vkMapMemory(device, tileA.memory, 0, tileBytes, 0, &mapped), "vkMapMemory(tileA)");
+        std::memcpy(back.data(), mapped, (size_t)tileBytes);
+        vkUnmapMemory(device, tileA.memory);
+    });
+
+    vkDestroyCommandPool(device, cmdPool, nullptr);
+    vkDestroyDescriptorPool(device, descPool, nullptr);
+    vkDestroyPipeline(device, pipeExtract, nullptr);
+    vkDestroyPipeline(device, pipeDown, nullptr);
+    vkDestroyShaderModule(device, modExtract, nullptr);
+    vkDestroyShaderModule(device, modDown, nullptr);
+    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    for (Buffer* b : { &hmBuf, &tileA, &tileB }) {
+        vkDestroyBuffer(device, b->buffer, nullptr);
+        vkFreeMemory(device, b->memory, nullptr);
+    }
+}
+
+// --- end to end ---
+static void macroBenches(const BenchArgs& a, const VulkanContext* ctx, const std::string& hmPath,
+                         std::vector<BenchResult>& out) {
+    const double pixels = (double)a.size * a.size;
+    const std::string world = a.workDir + "/world";
+
+    if (ctx) {
+        runBench(a, out, "build_e2e_lods1", pixels, "px", [&] {
+            BuildArgs b;
+            b.heightmapPath = hmPath;
+            b.outDir = world;
+            b.lodCount = 1;
+            runBuildCommand(ctx->device, ctx->physicalDevice, ctx->queue, ctx->computeQueueFamily, b);
+        });
+        // same, plus a typical --filter chain. own folder so the export benches see the unfiltered map
+        runBench(a, out, "build_e2e_filters", pixels, "px", [&] {
+            BuildArgs b;
+            b.heightmapPath = hmPath;
+            b.outDir = a.workDir + "/world_filtered";
+            b.lodCount = 1;
+            b.filters = parseFilterSteps("smooth:2,thermal:20,hydraulic:50");
+            runBuildCommand(ctx->device, ctx->physicalDevice, ctx->queue, ctx->computeQueueFamily, b);
+        });
+    }
+    if (!wanted(a, "export_e2e_grid") && !wanted(a, "export_e2e_rtin0.5_merge") && !wanted(a, "reader_sample")) return;
+
+    // export needs tiles on disk. without a GPU, cut them on the CPU
+    if (!std::filesystem::exists(world + "/tiles")) {
+        std::vector<uint16_t> hm;
+        uint32_t w = 0, h = 0;
+        loadHeightmap16(hmPath, w, h, hm);
+        for (uint32_t ty = 0; ty < h / TILE; ty++) {
+            for (uint32_t tx = 0; tx < w / TILE; tx++) {
+                const std::string dir = world + "/tiles/tile_" + std::to_string(tx) + "_" + std::to_string(ty);
+                std::filesystem::create_directories(dir);
+                std::vector<uint16_t> t((size_t)TILE * TILE);
+                for (uint32_t y = 0; y < TILE; y++)
+                    std::copy_n(hm.begin() + (size_t)(ty * TILE + y) * w + tx * TILE, TILE, t.begin() + (size_t)y * TILE);
+                writeRawU16(dir + "/lod0.height.raw", t);
+            }
+        }
+    }
+
+    ExportMeshArgs e;
+    e.inDir = world;
+    e.outDir = a.workDir + "/meshes";
+    e.heightScale = 100.0f;
+    runBench(a, out, "export_e2e_grid", pixels, "px", [&] { runExportMeshCommand(e); });
+    e.maxError = 0.5f;
+    runBench(a, out, "export_e2e_rtin0.5", pixels, "px", [&] { runExportMeshCommand(e); });
+    e.merge = true;
+    runBench(a, out, "export_e2e_rtin0.5_merge", pixels, "px", [&] { runExportMeshCommand(e); });
+
+    // 1M bilinear samples: a coherent sweep (rows of a 1000x1000 grid) and random points
+    const size_t samples = 1000000;
+    std::vector<float> xs(samples), zs(samples), hs(samples);
+    TerrainReader reader(world);
+    const float extent = float(a.size - 1);
+    for (size_t i = 0; i < samples; i++) {
+        xs[i] = float(i % 1000) / 1000.0f * extent;
+        zs[i] = float(i / 1000) / 1000.0f * extent;
+    }
+    runBench(a, out, "reader_sample_coherent", (double)samples, "samples", [&] {
+        reader.sampleMany(xs.data(), zs.data(), samples, 0, hs.data());
+    });
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(0.0f, extent);
+    for (size_t i = 0; i < samples; i++) { xs[i] = dist(rng); zs[i] = dist(rng); }
+    runBench(a, out, "reader_sample_random", (double)samples, "samples", [&] {
+        reader.sampleMany(xs.data(), zs.data(), samples, 0, hs.data());
+    });
+}
+
+// --- output ---
+static void writeResults(const BenchArgs& a, const std::string& device, const std::vector<BenchResult>& rs) {
+    std::ostringstream o;
+    if (a.format == "csv") {
+        o << "name,iters,mean_ms,min_ms,max_ms,items,unit,items_per_sec\n";
+        for (const auto& r : rs) {
+            o << r.name << "," << r.iters << "," << r.meanMs << "," << r.minMs << "," << r.maxMs << ","
+              << r.items << "," << r.unit << "," << (r.items > 0 ? r.items / (r.meanMs / 1000.0) : 0.0) << "\n";
+        }
+    } else {
+        o << "{\n  \"size\": " << a.size << ",\n  \"iters\": " << a.iters
+          << ",\n  \"device\": \"" << device << "\",\n  \"benchmarks\": [\n";
+        for (size_t i = 0; i < rs.size(); i++) {
+            const auto& r = rs[i];
+            o << "    {\"name\": \"" << r.name << "\", \"iters\": " << r.iters
+              << ", \"mean_ms\": " << r.meanMs << ", \"min_ms\": " << r.minMs << ", \"max_ms\": " << r.maxMs
+              << ", \"items\": " << r.items << ", \"unit\": \"" << r.unit << "\", \"items_per_sec\": "
+              << (r.items > 0 ? r.items / (r.meanMs / 1000.0) : 0.0) << "}" << (i + 1 < rs.size() ? "," : "") << "\n";
+        }
+        o << "  ]\n}\n";
+    }
+    std::ofstream f(a.outPath);
+    if (!f) throw std::runtime_error("Failed to write: " + a.outPath);
+    f << o.str();
+}
+
+static BenchArgs parseBenchArgs(int argc, char** argv) {
+    BenchArgs a;
+    for (int i = 1; i < argc; i++) {
+        std::string s = argv[i];
+        if (s == "--size" && i + 1 < argc) a.size = (uint32_t)std::stoul(argv[++i]);
+        else if (s == "--iters" && i + 1 < argc) a.iters = (uint32_t)std::stoul(argv[++i]);
+        else if (s == "--filter" && i + 1 < argc) a.filter = argv[++i];
+        else if (s == "--no-gpu") a.gpu = false;
+        else if (s == "--format" && i + 1 < argc) a.format = argv[++i];
+        else if (s == "--out" && i + 1 < argc) a.outPath = argv[++i];
+        else if (s == "--work-dir" && i + 1 < argc) a.workDir = argv[++i];
+    }
+    return a;
+}
+
+int main(int argc, char** argv) {
+    BenchArgs a = parseBenchArgs(argc, argv);
+    if (a.size == 0 || (a.size % TILE) != 0) {
+        std::cerr << "--size must be a multiple of " << TILE << "\n";
+        return 1;
+    }
+
+    try {
+        std::filesystem::create_directories(a.workDir);
+        const auto hm = makeTerrain(a.size, a.size);
+        const std::string hmPath = a.workDir + "/synthetic.pgm";
+        writePGM16(hmPath, a.size, a.size, hm);
+
+        std::vector<BenchResult> results;
+        std::cout << "cpu (" << a.size << "x" << a.size << "):\n";
+        cpuBenches(a, hmPath, hm, results);
+
+        std::string deviceName = "none";
+        VulkanContext ctx;
+        bool haveGpu = false;
+        if (a.gpu) {
+            try {
+                ctx = createVulkanContext(false);
+                haveGpu = true;
+                VkPhysicalDeviceProperties p{};
+                vkGetPhysicalDeviceProperties(ctx.physicalDevice, &p);
+                deviceName = p.deviceName;
+            } catch (const std::exception& e) {
+                std::cerr << "[Warn] skipping GPU benchmarks: " << e.what() << "\n";
+            }
+        }
+        if (haveGpu) {
+            std::cout << "gpu (" << deviceName << "):\n";
+            gpuBenches(a, ctx, hm, results);
+        }
+
+        std::cout << "end to end:\n";
+        std::filesystem::remove_all(a.workDir + "/world");
+        macroBenches(a, haveGpu ? &ctx : nullptr, hmPath, results);
+        if (haveGpu) destroyVulkanContext(ctx);
+
+        if (!a.outPath.empty()) {
+            writeResults(a, deviceName, results);
+            std::cout << "Results written to: " << a.outPath << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "bench error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
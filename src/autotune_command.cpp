@@ -0,0 +1,429 @@
+#include "autotune_command.h"
+#include "kernel_profile.h"
+#include "push_constants.h"
+#include "splat_rules.h"
+#include "trace.h"
+#include "vk_util.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+/*
+autotune_command.cpp
+
+1) Device limits (max workgroup size/invocations, subgroup size) decide which shapes are tried
+2) Synthetic 4x4 tile heightmap + the same buffers/descriptor layout build uses
+3) Per kernel, per shape: specialize the pipeline, record what build dispatches for 16 tiles into one
+   command buffer, time it (timestamp queries, CPU clock if the queue has none). One warmup, best of iters.
+   Output is compared against the 16x16 default so a shape with an indexing problem can't win
+4) Fastest shape per kernel -> saveKernelProfile under this device's UUID and the tile size. build picks
+   it up from there when it builds with the same --tile-size
+*/
+
+//helpers
+static constexpr uint32_t TEST_TILES = 4; // test map is TEST_TILES x TEST_TILES tiles
+
+// workgroup shapes tried for every kernel (x, y), before the device limits
+static const uint32_t SHAPES[][2] = {
+    { 8, 8 },  { 16, 8 },  { 8, 16 },  { 16, 16 }, { 32, 8 },  { 8, 32 },
+    { 32, 16 }, { 16, 32 }, { 32, 32 }, { 64, 1 },  { 64, 2 },  { 64, 4 },
+    { 64, 8 },  { 64, 16 }, { 128, 1 }, { 128, 2 }, { 128, 4 }, { 256, 1 },
+};
+static const uint32_t ROWS_PER_THREAD[] = { 1, 2, 4, 8 };
+
+static uint32_t subgroupSize(VkPhysicalDevice physicalDevice)
+{
+    VkPhysicalDeviceSubgroupProperties sg{};
+    sg.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+    VkPhysicalDeviceProperties2 props2{};
+    props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props2.pNext = &sg;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &props2);
+    return sg.subgroupSize;
+}
+
+// default (16x16, 1 row) first: it is the reference output and the baseline time
+static std::vector<KernelConfig> candidateConfigs(const VkPhysicalDeviceLimits& limits, uint32_t subgroup, uint32_t tileSize)
+{
+    std::vector<KernelConfig> out{ KernelConfig{} };
+    for (const auto& s : SHAPES) {
+        for (uint32_t rows : ROWS_PER_THREAD) {
+            const KernelConfig c{ s[0], s[1], rows };
+            if (c.localX == 16 && c.localY == 16 && c.rows == 1) continue;
+            if (!kernelConfigFits(c, limits)) continue;
+            // partial subgroups leave lanes idle in every workgroup
+            if (subgroup > 0 && (c.localX * c.localY) % subgroup != 0) continue;
+            if (c.localX > tileSize || c.localY * c.rows > tileSize) continue;
+            out.push_back(c);
+        }
+    }
+    return out;
+}
+
+// splat.comp's cost depends on the material count and ranges (only the specialization constants), so
+// time it with all 4 materials and blends, like src/assets/splat_rules.json
+static SplatRules makeTestSplatRules()
+{
+    SplatRules rules;
+    rules.materials.resize(SPLAT_MAX_MATERIALS);
+    rules.materials[0].height = { -1e30f, 0.12f, 0.02f };
+    rules.materials[0].slope = { -1e30f, 25.0f, 5.0f };
+    rules.materials[1].height = { 0.1f, 0.7f, 0.05f };
+    rules.materials[1].slope = { -1e30f, 30.0f, 5.0f };
+    rules.materials[2].slope = { 30.0f, 1e30f, 5.0f };
+    rules.materials[3].height = { 0.7f, 1.0f, 0.05f };
+    rules.materials[3].slope = { -1e30f, 45.0f, 5.0f };
+    return rules;
+}
+
+// rolling hills + a ridge pattern so downsample/normals/splat don't run on flat data
+static std::vector<uint32_t> makeTestHeightmap(uint32_t size)
+{
+    std::vector<uint32_t> hm((size_t)size * size);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            const float fx = (float)x / (float)size;
+            const float fy = (float)y / (float)size;
+            float h = 0.5f + 0.25f * std::sin(fx * 6.2831853f * 3.0f) * std::cos(fy * 6.2831853f * 2.0f)
+                    + 0.15f * std::fabs(std::sin((fx + fy) * 6.2831853f * 9.0f)) - 0.075f;
+            h = std::clamp(h, 0.0f, 1.0f);
+            hm[(size_t)y * size + x] = (uint32_t)(h * 65535.0f);
+        }
+    }
+    return hm;
+}
+
+static void printConfig(const KernelConfig& c)
+{
+    std::cout << std::setw(4) << c.localX << " x" << std::setw(4) << c.localY << " x" << std::setw(2) << c.rows;
+}
+
+// -- Run Autotune Command
+int runAutotuneCommand(VkDevice device,
+                       VkPhysicalDevice physicalDevice,
+                       VkQueue queue,
+                       uint32_t computeQueueFamily,
+                       const AutotuneArgs& args)
+{
+    const uint32_t TILE_SIZE = args.tileSize;
+    if (TILE_SIZE < 64 || TILE_SIZE > 1024 || (TILE_SIZE & (TILE_SIZE - 1)) != 0) {
+        throw std::runtime_error("--tile-size must be a power of two from 64 to 1024.");
+    }
+    const uint32_t mapSize = TILE_SIZE * TEST_TILES;
+
+    // ---- 1) Device + candidates ----
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    const uint32_t subgroup = subgroupSize(physicalDevice);
+
+    KernelProfile profile;
+    profile.deviceUUID = deviceUUIDString(physicalDevice);
+    profile.deviceName = props.deviceName;
+    profile.tileSize = TILE_SIZE;
+
+    const std::vector<KernelConfig> candidates = candidateConfigs(props.limits, subgroup, TILE_SIZE);
+    std::cout << "Autotuning " << profile.deviceName << " (" << profile.deviceUUID << ")"
+              << " | subgroup=" << subgroup << " | tileSize=" << TILE_SIZE
+              << " | " << candidates.size() << " shapes per kernel\n";
+
+    // ---- 2) Layouts, buffers, descriptor sets ----
+    VkDescriptorSetLayout setLayout = makeSetLayout(device);
+    VkPipelineLayout pipelineLayout = makePipelineLayout(device, setLayout, 32);
+
+    const VkMemoryPropertyFlags hostMem =
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    const VkDeviceSize hmBytes = sizeof(uint32_t) * (VkDeviceSize)mapSize * mapSize;
+    const VkDeviceSize tileBytes = sizeof(uint32_t) * (VkDeviceSize)TILE_SIZE * TILE_SIZE;
+    //tileA is the downsample source and never written while downsample is timed. B/C ping-pong
+    Buffer hmBuf = createBuffer(device, physicalDevice, hmBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    Buffer tileA = createBuffer(device, physicalDevice, tileBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    Buffer tileB = createBuffer(device, physicalDevice, tileBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    Buffer tileC = createBuffer(device, physicalDevice, tileBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    Buffer normBuf = createBuffer(device, physicalDevice, tileBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+
+    auto fill = [&](const Buffer& b, const void* src, VkDeviceSize bytes, int value) {
+        void* mapped = nullptr;
+        vkCheck(vkMapMemory(device, b.memory, 0, bytes, 0, &mapped), "vkMapMemory(autotune)");
+        if (src) std::memcpy(mapped, src, (size_t)bytes);
+        else std::memset(mapped, value, (size_t)bytes);
+        vkUnmapMemory(device, b.memory);
+    };
+    auto readBack = [&](const Buffer& b, std::vector<uint32_t>& out) {
+        const size_t count = (size_t)(b.size / sizeof(uint32_t));
+        const size_t old = out.size();
+        out.resize(old + count);
+        void* mapped = nullptr;
+        vkCheck(vkMapMemory(device, b.memory, 0, b.size, 0, &mapped), "vkMapMemory(autotune readBack)");
+        std::memcpy(out.data() + old, mapped, count * sizeof(uint32_t));
+        vkUnmapMemory(device, b.memory);
+    };
+
+    {
+        const std::vector<uint32_t> hm = makeTestHeightmap(mapSize);
+        fill(hmBuf, hm.data(), hmBytes, 0);
+        // downsample input: tile (1,1) of the test map
+        std::vector<uint32_t> tile((size_t)TILE_SIZE * TILE_SIZE);
+        for (uint32_t y = 0; y < TILE_SIZE; y++) {
+            std::memcpy(&tile[(size_t)y * TILE_SIZE], &hm[(size_t)(TILE_SIZE + y) * mapSize + TILE_SIZE],
+                        TILE_SIZE * sizeof(uint32_t));
+        }
+        fill(tileA, tile.data(), tileBytes, 0);
+    }
+
+    enum { SET_EXTRACT, SET_A_TO_B, SET_B_TO_C, SET_C_TO_B, SET_NORMALS, SET_COUNT };
+    VkDescriptorPoolSize ps{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * SET_COUNT };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = SET_COUNT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &ps;
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    vkCheck(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descPool), "vkCreateDescriptorPool");
+
+    std::vector<VkDescriptorSetLayout> layouts(SET_COUNT, setLayout);
+    VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    ai.descriptorPool = descPool;
+    ai.descriptorSetCount = SET_COUNT;
+    ai.pSetLayouts = layouts.data();
+    VkDescriptorSet sets[SET_COUNT]{};
+    vkCheck(vkAllocateDescriptorSets(device, &ai, sets), "vkAllocateDescriptorSets");
+
+    auto bind2 = [&](VkDescriptorSet set, const Buffer& in, const Buffer& out) {
+        VkDescriptorBufferInfo inInfo{ in.buffer, 0, in.size };
+        VkDescriptorBufferInfo outInfo{ out.buffer, 0, out.size };
+        VkWriteDescriptorSet w[2]{};
+        for (int i = 0; i < 2; i++) {
+            w[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[i].dstSet = set;
+            w[i].dstBinding = (uint32_t)i;
+            w[i].descriptorCount = 1;
+            w[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[i].pBufferInfo = i == 0 ? &inInfo : &outInfo;
+        }
+        vkUpdateDescriptorSets(device, 2, w, 0, nullptr);
+    };
+    bind2(sets[SET_EXTRACT], hmBuf, tileB);
+    bind2(sets[SET_A_TO_B], tileA, tileB);
+    bind2(sets[SET_B_TO_C], tileB, tileC);
+    bind2(sets[SET_C_TO_B], tileC, tileB);
+    bind2(sets[SET_NORMALS], hmBuf, normBuf);
+
+    VkCommandPoolCreateInfo cpInfo{ VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    cpInfo.queueFamilyIndex = computeQueueFamily;
+    cpInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    VkCommandPool cmdPool = VK_NULL_HANDLE;
+    vkCheck(vkCreateCommandPool(device, &cpInfo, nullptr, &cmdPool), "vkCreateCommandPool");
+    VkCommandBufferAllocateInfo cbAlloc{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cbAlloc.commandPool = cmdPool;
+    cbAlloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cbAlloc.commandBufferCount = 1;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    vkCheck(vkAllocateCommandBuffers(device, &cbAlloc, &cmd), "vkAllocateCommandBuffers");
+
+    // timestamps around the whole command buffer when the queue has them
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    uint64_t timestampMask = ~0ull;
+    {
+        uint32_t qCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &qCount, nullptr);
+        std::vector<VkQueueFamilyProperties> qProps(qCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &qCount, qProps.data());
+        const uint32_t validBits = qProps[computeQueueFamily].timestampValidBits;
+        if (validBits > 0) {
+            if (validBits < 64) timestampMask = (1ull << validBits) - 1;
+            VkQueryPoolCreateInfo qpInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+            qpInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            qpInfo.queryCount = 2;
+            vkCheck(vkCreateQueryPool(device, &qpInfo, nullptr, &queryPool), "vkCreateQueryPool");
+        } else {
+            std::cerr << "[Warn] compute queue has no timestamps, timing submit + wait on the CPU instead.\n";
+        }
+    }
+
+    // ---- 3) What build records per tile, 16 tiles per run ----
+    // build waits after every dispatch, here a barrier does the same job inside one command buffer
+    auto barrier = [&]() {
+        VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+        mb.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+        mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                             0, 1, &mb, 0, nullptr, 0, nullptr);
+    };
+    auto bindSet = [&](VkDescriptorSet set) {
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &set, 0, nullptr);
+    };
+    auto dispatch = [&](const KernelConfig& cfg, const void* pc, uint32_t pcBytes, uint32_t size) {
+        vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, pcBytes, pc);
+        vkCmdDispatch(cmd, kernelGroupsX(cfg, size), kernelGroupsY(cfg, size), 1);
+        barrier();
+    };
+
+    auto recordExtract = [&](const KernelConfig& cfg) {
+        bindSet(sets[SET_EXTRACT]);
+        for (uint32_t ty = 0; ty < TEST_TILES; ty++) {
+            for (uint32_t tx = 0; tx < TEST_TILES; tx++) {
+                PCExtract pc{ mapSize, mapSize, tx, ty };
+                dispatch(cfg, &pc, sizeof(pc), TILE_SIZE);
+            }
+        }
+    };
+    // the whole LOD chain (down to 8 px) per tile: A -> B -> C -> B ...
+    auto recordDownsample = [&](const KernelConfig& cfg) {
+        for (uint32_t t = 0; t < TEST_TILES * TEST_TILES; t++) {
+            uint32_t lod = 0;
+            for (uint32_t size = TILE_SIZE / 2; size >= 8; size /= 2, lod++) {
+                bindSet(sets[lod == 0 ? SET_A_TO_B : (lod % 2 ? SET_B_TO_C : SET_C_TO_B)]);
+                PCDownsample pc{ size * 2 };
+                dispatch(cfg, &pc, sizeof(pc), size);
+            }
+        }
+    };
+    // LOD0 and LOD1 normals (the sizes most of the work is in). splat takes the same push constants and
+    // output, so it is timed with this too
+    auto recordNormals = [&](const KernelConfig& cfg) {
+        bindSet(sets[SET_NORMALS]);
+        for (uint32_t ty = 0; ty < TEST_TILES; ty++) {
+            for (uint32_t tx = 0; tx < TEST_TILES; tx++) {
+                for (uint32_t step = 1; step <= 2; step++) {
+                    PCNormals pc{ mapSize, mapSize, tx, ty, step, 100.0f };
+                    dispatch(cfg, &pc, sizeof(pc), TILE_SIZE / step);
+                }
+            }
+        }
+    };
+
+    // one warmup, then iters runs. fastest run in microseconds
+    auto timeRuns = [&](VkPipeline pipe, const std::function<void()>& record) {
+        VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+        VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmd;
+
+        double best = 1e300;
+        for (uint32_t i = 0; i <= std::max(1u, args.iters); i++) {
+            vkCheck(vkResetCommandBuffer(cmd, 0), "vkResetCommandBuffer");
+            vkCheck(vkBeginCommandBuffer(cmd, &beginInfo), "vkBeginCommandBuffer");
+            if (queryPool) {
+                vkCmdResetQueryPool(cmd, queryPool, 0, 2);
+                vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+            }
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipe);
+            record();
+            if (queryPool) vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
+            vkCheck(vkEndCommandBuffer(cmd), "vkEndCommandBuffer");
+
+            const auto t0 = std::chrono::steady_clock::now();
+            vkCheck(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE), "vkQueueSubmit");
+            vkCheck(vkQueueWaitIdle(queue), "vkQueueWaitIdle");
+            double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+
+            if (queryPool) {
+                uint64_t ts[2]{};
+                vkCheck(vkGetQueryPoolResults(device, queryPool, 0, 2, sizeof(ts), ts, sizeof(uint64_t),
+                    VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT), "vkGetQueryPoolResults");
+                const uint64_t ticks = ((ts[1] & timestampMask) - (ts[0] & timestampMask)) & timestampMask;
+                us = double(ticks) * props.limits.timestampPeriod / 1000.0;
+            }
+            if (i > 0) best = std::min(best, us);
+        }
+        return best;
+    };
+
+    struct KernelCase {
+        const char* name;
+        const char* spvName;
+        KernelConfig* result;
+        std::function<void(const KernelConfig&)> record;
+        std::vector<const Buffer*> outputs; // cleared before and compared after every shape
+        bool splat = false; // specialized with makeSplatSpec (test rules) instead of makeKernelSpec
+    };
+    std::vector<KernelCase> kernels = {
+        { "extract_tile", "extract_tile.comp.spv", &profile.extract, recordExtract, { &tileB } },
+        { "downsample", "downsample.comp.spv", &profile.downsample, recordDownsample, { &tileB, &tileC } },
+        { "normals", "normals.comp.spv", &profile.normals, recordNormals, { &normBuf } },
+        { "splat", "splat.comp.spv", &profile.splat, recordNormals, { &normBuf }, true },
+    };
+    const SplatRules splatRules = makeTestSplatRules();
+
+    std::exception_ptr exPtr = nullptr;
+    try {
+        for (KernelCase& k : kernels) {
+            TraceSpan span(k.name);
+            std::cout << "\n" << k.name << "\n";
+
+            std::vector<uint32_t> reference;
+            double defaultUs = 0.0;
+            KernelConfig best;
+            double bestUs = 1e300;
+            for (size_t ci = 0; ci < candidates.size(); ci++) {
+                const KernelConfig& c = candidates[ci];
+                KernelSpec spec;
+                SplatSpec splatSpec;
+                makeKernelSpec(TILE_SIZE, c, spec);
+                if (k.splat) makeSplatSpec(TILE_SIZE, c, splatRules, splatSpec);
+                VkShaderModule mod = VK_NULL_HANDLE;
+                VkPipeline pipe = makeComputePipeline(device, pipelineLayout, shaderPath(k.spvName), &mod,
+                                                      k.splat ? &splatSpec.info : &spec.info);
+
+                for (const Buffer* b : k.outputs) fill(*b, nullptr, b->size, 0xFF);
+                const double us = timeRuns(pipe, [&] { k.record(c); });
+                std::vector<uint32_t> got;
+                for (const Buffer* b : k.outputs) readBack(*b, got);
+
+                vkDestroyPipeline(device, pipe, nullptr);
+                vkDestroyShaderModule(device, mod, nullptr);
+
+                std::cout << "  ";
+                printConfig(c);
+                if (ci == 0) {
+                    reference = std::move(got);
+                    defaultUs = us;
+                } else if (got != reference) {
+                    std::cout << "  wrong output, skipped\n";
+                    continue;
+                }
+                std::cout << std::fixed << std::setprecision(1) << std::setw(10) << us << " us"
+                          << std::setprecision(2) << std::setw(7) << defaultUs / us << "x\n";
+                if (us < bestUs) {
+                    bestUs = us;
+                    best = c;
+                }
+            }
+            // timing noise: keep 16x16 unless the winner is clearly faster
+            if (bestUs > defaultUs * 0.97) {
+                best = KernelConfig{};
+                bestUs = defaultUs;
+            }
+            *k.result = best;
+            std::cout << "  -> ";
+            printConfig(best);
+            std::cout << std::setprecision(2) << "  (" << defaultUs / bestUs << "x vs 16 x 16 x 1)\n";
+        }
+        saveKernelProfile(args.profilePath, profile);
+    } catch (...) {
+        exPtr = std::current_exception();
+    }
+
+    // ---- Cleanup ----
+    if (queryPool) vkDestroyQueryPool(device, queryPool, nullptr);
+    vkDestroyCommandPool(device, cmdPool, nullptr);
+    vkDestroyDescriptorPool(device, descPool, nullptr);
+    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+    vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    for (Buffer* b : { &hmBuf, &tileA, &tileB, &tileC, &normBuf }) {
+        vkDestroyBuffer(device, b->buffer, nullptr);
+        vkFreeMemory(device, b->memory, nullptr);
+    }
+
+    if (exPtr) std::rethrow_exception(exPtr);
+    std::cout << "\nSaved profile for " << profile.deviceName << " to " << args.profilePath
+              << ". build uses it automatically\n";
+    return 0;
+}
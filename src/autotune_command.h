@@ -0,0 +1,18 @@
+#pragma once
+#include "kernel_profile.h"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+
+struct AutotuneArgs {
+    std::string profilePath = DEFAULT_PROFILE_PATH; // this GPU's entry is added/replaced, others are kept
+    uint32_t tileSize = 256;  // tune for this build --tile-size
+    uint32_t iters = 10;      // timed runs per shape, the fastest counts
+};
+
+int runAutotuneCommand(VkDevice device,
+                       VkPhysicalDevice physicalDevice,
+                       VkQueue queue,
+                       uint32_t computeQueueFamily,
+                       const AutotuneArgs& args);
@@ -0,0 +1,85 @@
+#pragma once
+#include "trace.h"
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+
+// --- Bounded Buffer ---
+// shared by build (image encoder) and export_mesh (jobQ / writeQ)
+// with --trace: occupancy counter on every push/pop, and a span whenever a push/pop had to sleep
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t cap) : cap_(cap) {}
+
+    // name shown in the trace ("jobQ" -> "jobQ" counter, "jobQ push wait", "jobQ pop wait")
+    void setTraceName(const std::string& name) {
+        traceName_ = traceIntern(name);
+        pushWaitName_ = traceIntern(name + " push wait");
+        popWaitName_ = traceIntern(name + " pop wait");
+    }
+
+    // blocks if full returns false if closed
+    bool push(T item) {
+        const bool tracing = traceName_ && traceEnabled();
+        const uint64_t t0 = tracing ? traceNowUs() : 0;
+        std::unique_lock<std::mutex> lk(m_);//wait(mutex)
+        const bool waited = !closed_ && q_.size() >= cap_;
+        cvNotFull_.wait(lk, [&] { return closed_ || q_.size() < cap_; }); //if predicate is true, go immediately. Else sleep.//wait(empty)
+        if (closed_) return false;
+        q_.push_back(std::move(item));  //Critical section. Writes to buffer
+        cvNotEmpty_.notify_one();       //signal(full)
+        if (tracing) {
+            const size_t n = q_.size();
+            lk.unlock();
+            traceSample(pushWaitName_, waited, t0, n);
+        }
+        return true;                    //mutex automatically signals. signal(mutex)
+    }
+
+    // blocks if empty; returns false if empty+closed
+    bool pop(T& out) {
+        const bool tracing = traceName_ && traceEnabled();
+        const uint64_t t0 = tracing ? traceNowUs() : 0;
+        std::unique_lock<std::mutex> lk(m_);//wait(mutex)
+        const bool waited = !closed_ && q_.empty();
+        cvNotEmpty_.wait(lk, [&] { return closed_ || !q_.empty(); });//if predicate is true, go immediately. Else sleep.//wait(full)
+        if (q_.empty()) return false; // closed + empty
+        out = std::move(q_.front());
+        q_.pop_front();
+        cvNotFull_.notify_one();       //signal(empty)
+        if (tracing) {
+            const size_t n = q_.size();
+            lk.unlock();
+            traceSample(popWaitName_, waited, t0, n);
+        }
+        return true;                //mutex automatically signals. signal(mutex)
+    }
+
+    void close() {
+        std::lock_guard<std::mutex> lk(m_);
+        closed_ = true;
+        cvNotEmpty_.notify_all();
+        cvNotFull_.notify_all();
+    }
+
+private:
+    void traceSample(const char* waitName, bool waited, uint64_t t0, size_t size) {
+        if (waited) traceComplete(waitName, t0, traceNowUs() - t0);
+        traceCounter(traceName_, (int64_t)size);
+    }
+
+    size_t cap_;
+    std::deque<T> q_;
+    bool closed_ = false;
+    std::mutex m_;
+    std::condition_variable cvNotEmpty_;
+    std::condition_variable cvNotFull_;
+
+    const char* traceName_ = nullptr;
+    const char* pushWaitName_ = nullptr;
+    const char* popWaitName_ = nullptr;
+};
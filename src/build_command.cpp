@@ -1,16 +1,25 @@
 #include "build_command.h"
+#include "bounded_queue.h"
+#include "heightmap_io.h"
+#include "kernel_profile.h"
+#include "minmax_index.h"
+#include "morton.h"
+#include "push_constants.h"
+#include "scope_exit.h"
+#include "splat_rules.h"
+#include "trace.h"
 #include "vk_util.h"
 
-#define STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include "./third_party/stb_image_write.h"
-#include "./third_party/stb_image.h"
 
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <vector>
 #include <cstring>
+#include <thread>
+#include <mutex>
+#include <exception>
 
 /*
 build_command.cpp
@@ -19,52 +28,77 @@ build_command.cpp
 2) Create Descriptor + Extract pipeline layouts. Create extract pipeline
 3) Create buffers. Put hmBuff info into GPU memory
 4) Create CMD pool and CMD buffer
-5) Tile Loop. Dispatch 16x16 work groups in parallel. 16x16 threads each workgroups. Total 65536 invocations.
-6) Clear
+   (optional) --filter: smoothing/erosion on hmBuf itself (terrain_filter.cpp), so every tile sees it
+   --tile-size (64..1024, power of two) reaches the shaders as specialization constant 0. Maps that are
+   not a multiple of it get padded edge tiles (the shaders clamp to the last row/column)
+   Workgroup shape + rows per thread come from the autotune profile for this GPU (spec constants 1..3,
+   kernel_profile.h), 16x16 and 1 row without one
+5) Tile Loop, in Morton order (morton.h). Dispatch enough workgroups to cover the tile.
+   Then downsample tileA <-> tileB for every extra LOD. (optional) bake normals per tile and LOD
+   (optional) --splat: material weights per tile and LOD from rules.json (splat.comp, RGBA8)
+   Every tile/LOD also gets a min/max quadtree (one workgroup, minmax.comp) that goes into minmax.index
+6) Clear (a ScopeExit guard set up before any handle is created, so it also runs when setup throws)
+
+ normal/slope and splat PNGs are encoded on their own thread so the GPU loop never waits on zlib:
+ tile loop -> [encodeQ 8] -> encoder (stb_image_write)
+
+ with --trace every dispatch is bracketed by vkCmdWriteTimestamp so GPU time shows up
+ separately from submit/wait, readback and disk writes
 */
 
 //helpers
-static void loadHeightmap16(const std::string &path, uint32_t &w, uint32_t &h, std::vector<uint16_t> &out)
-{
-    int iw = 0, ih = 0, c = 0;
-    // stbi_load_16 gives 16-bit per channel
-    uint16_t *img = stbi_load_16(path.c_str(), &iw, &ih, &c, 1);
-    if (!img)
-        throw std::runtime_error("Failed to load 16-bit heightmap: " + path);
-
-    w = (uint32_t)iw;
-    h = (uint32_t)ih;
-    out.assign(img, img + (size_t)w * (size_t)h);
-    stbi_image_free(img);
-}
 static void ensureDir(const std::string &path)
 {
     std::filesystem::create_directories(std::filesystem::path(path));
 }
-static void writeRawU16(const std::string &path, const std::vector<uint16_t> &data)
+// one baked tile/LOD waiting for PNG encoding. px is RGBA8:
+// normals: rgb = normal, a = slope -> normalPath + slopePath. splat: 4 material weights -> splatPath as is
+struct ImageJob
+{
+    std::string normalPath;
+    std::string slopePath;
+    std::string splatPath;
+    uint32_t size = 0;
+    std::vector<uint32_t> px;
+    TraceTile tile;
+};
+
+static void writeNormalAndSlopePNG(const ImageJob& j)
 {
-    std::ofstream f(path, std::ios::binary);
-    if (!f)
-        throw std::runtime_error("Failed to write: " + path);
-    f.write(reinterpret_cast<const char *>(data.data()),
-            (std::streamsize)(data.size() * sizeof(uint16_t)));
+    TraceSpan span("encode_png", j.tile);
+    const size_t count = (size_t)j.size * j.size;
+    std::vector<uint8_t> rgb(count * 3);
+    std::vector<uint8_t> slope(count);
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(j.px.data());
+    for (size_t i = 0; i < count; i++) {
+        rgb[i * 3 + 0] = src[i * 4 + 0];
+        rgb[i * 3 + 1] = src[i * 4 + 1];
+        rgb[i * 3 + 2] = src[i * 4 + 2];
+        slope[i] = src[i * 4 + 3];
+    }
+    const int w = (int)j.size;
+    if (!stbi_write_png(j.normalPath.c_str(), w, w, 3, rgb.data(), w * 3))
+        throw std::runtime_error("Failed to write: " + j.normalPath);
+    if (!stbi_write_png(j.slopePath.c_str(), w, w, 1, slope.data(), w))
+        throw std::runtime_error("Failed to write: " + j.slopePath);
 }
-// push constant structs
-struct PCExtract
+
+static void writeSplatPNG(const ImageJob& j)
 {
-    uint32_t hmWidth; //tell GPU how wide orignical big img is to calc where next row starts
-    uint32_t tileX;//tell gpu which exact sqr to cut
-    uint32_t tileY;
-};
+    TraceSpan span("encode_splat_png", j.tile);
+    const int w = (int)j.size;
+    if (!stbi_write_png(j.splatPath.c_str(), w, w, 4, j.px.data(), w * 4))
+        throw std::runtime_error("Failed to write: " + j.splatPath);
+}
 
-struct PCDownsample
+static void writeImageJob(const ImageJob& j)
 {
-    uint32_t inSize;
-};
+    if (!j.splatPath.empty()) writeSplatPNG(j);
+    else writeNormalAndSlopePNG(j);
+}
 
-static constexpr uint32_t TILE_SIZE = 256;
-static constexpr uint32_t LOCAL_X = 16;
-static constexpr uint32_t LOCAL_Y = 16;
+// minmax.comp is always one 16x16 workgroup (it strides over the tile itself)
+static constexpr KernelConfig MINMAX_GROUP{ 16, 16, 1 };
 static uint32_t ceilDiv(uint32_t a, uint32_t b) { return (a + b - 1) / b; }
 
 // -- Run Build Command *Parallel Computing step in stage 5
@@ -74,34 +108,125 @@ int runBuildCommand(VkDevice device,
                     uint32_t computeQueueFamily,
                     const BuildArgs& args)
 {
+    const uint32_t TILE_SIZE = args.tileSize;
+    if (TILE_SIZE < 64 || TILE_SIZE > 1024 || (TILE_SIZE & (TILE_SIZE - 1)) != 0) {
+        throw std::runtime_error("--tile-size must be a power of two from 64 to 1024.");
+    }
+    // LOD n is TILE_SIZE >> n pixels wide, so a 256 tile has 9 (256 .. 1). minmax.index stores lodCount
+    // as given and readMinMaxIndex rejects 0 or more than 32
+    uint32_t maxLods = 1;
+    while ((TILE_SIZE >> maxLods) != 0) maxLods++;
+    if (args.lodCount < 1 || args.lodCount > maxLods) {
+        throw std::runtime_error("--lods must be 1.." + std::to_string(maxLods) + " for tile size " + std::to_string(TILE_SIZE) + ".");
+    }
+
     // ---- 1) Load heightmap ----
     uint32_t hmW = 0, hmH = 0;
     std::vector<uint16_t> hmU16;
-    loadHeightmap16(args.heightmapPath, hmW, hmH, hmU16);
+    {
+        TraceSpan span("load_heightmap");
+        loadHeightmap16(args.heightmapPath, hmW, hmH, hmU16);
+    }
 
     if (hmW == 0 || hmH == 0) throw std::runtime_error("Heightmap has 0 size.");
-    if ((hmW % TILE_SIZE) != 0 || (hmH % TILE_SIZE) != 0) {
-        throw std::runtime_error("Heightmap width/height must be divisible by 256 for now.");
-    }
 
-    const uint32_t tilesX = hmW / TILE_SIZE;
-    const uint32_t tilesY = hmH / TILE_SIZE;
+    //rules go into splat.comp as specialization constants, so a bad file fails before any GPU work
+    const bool splat = !args.splatRulesPath.empty();
+    SplatRules splatRules;
+    if (splat) splatRules = loadSplatRules(args.splatRulesPath);
+
+    // last column/row of tiles may hang over the map edge. those pixels repeat the edge
+    const uint32_t tilesX = ceilDiv(hmW, TILE_SIZE);
+    const uint32_t tilesY = ceilDiv(hmH, TILE_SIZE);
 
     ensureDir(args.outDir);
     ensureDir(args.outDir + "/tiles");
 
     // ---- 2) Create layouts + pipelines ----
-    VkDescriptorSetLayout setLayout = makeSetLayout(device);
-    // push constants: PCExtract is 12 bytes, so we will reseve 16 bytes
-    VkPipelineLayout pipelineLayout = makePipelineLayout(device, setLayout, 16);
-    //tell OS theses are empty rn
+    KernelProfile profile;
+    if (loadKernelProfile(args.profilePath, deviceUUIDString(physicalDevice), TILE_SIZE, profile)) {
+        std::cout << "Using autotune profile " << args.profilePath << " (" << profile.deviceName
+                  << ", tile size " << profile.tileSize << ")\n";
+    }
+    //a hand edited or stale profile can ask for more than this device runs: those entries go back to 16x16
+    {
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+        const std::pair<const char*, KernelConfig*> entries[] = {
+            { "extract", &profile.extract }, { "downsample", &profile.downsample },
+            { "normals", &profile.normals }, { "splat", &profile.splat },
+        };
+        for (const auto& [name, cfg] : entries) {
+            if (kernelConfigFits(*cfg, props.limits)) continue;
+            std::cerr << "[Warn] autotune profile: " << name << " " << cfg->localX << "x" << cfg->localY
+                      << " is over this GPU's workgroup limits, using 16x16\n";
+            *cfg = KernelConfig{};
+        }
+    }
+    //every handle starts empty and the guard below destroys whatever got created, on success or throw
+    VkDescriptorSetLayout setLayout = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
     VkShaderModule modExtract = VK_NULL_HANDLE;
     VkShaderModule modDown = VK_NULL_HANDLE;
+    VkShaderModule modNormals = VK_NULL_HANDLE;
+    VkShaderModule modMinMax = VK_NULL_HANDLE;
+    VkShaderModule modSplat = VK_NULL_HANDLE;
+    VkPipeline pipeExtract = VK_NULL_HANDLE;
+    VkPipeline pipeDownsample = VK_NULL_HANDLE;
+    VkPipeline pipeMinMax = VK_NULL_HANDLE;
+    VkPipeline pipeNormals = VK_NULL_HANDLE;
+    VkPipeline pipeSplat = VK_NULL_HANDLE;
+    Buffer hmBuf{}, tileA{}, tileB{}, minMaxBuf{}, normBuf{}, splatBuf{};
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    VkCommandPool cmdPool = VK_NULL_HANDLE;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+
+    // ---- 6) Cleanup (runs when this function returns or throws) ----
+    ScopeExit cleanup([&] {
+        vkQueueWaitIdle(queue); // nothing may still be running when a throw skipped the wait
+        if (queryPool) vkDestroyQueryPool(device, queryPool, nullptr);
+        if (cmdPool) vkDestroyCommandPool(device, cmdPool, nullptr);
+        if (descPool) vkDestroyDescriptorPool(device, descPool, nullptr);
+
+        for (VkPipeline p : { pipeExtract, pipeDownsample, pipeMinMax, pipeNormals, pipeSplat })
+            if (p) vkDestroyPipeline(device, p, nullptr);
+        for (VkShaderModule m : { modExtract, modDown, modMinMax, modNormals, modSplat })
+            if (m) vkDestroyShaderModule(device, m, nullptr);
+
+        if (pipelineLayout) vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+        if (setLayout) vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+
+        for (const Buffer* b : { &hmBuf, &tileA, &tileB, &minMaxBuf, &normBuf, &splatBuf }) {
+            if (b->buffer) vkDestroyBuffer(device, b->buffer, nullptr);
+            if (b->memory) vkFreeMemory(device, b->memory, nullptr);
+        }
+    });
+
+    setLayout = makeSetLayout(device);
+    // push constants: biggest is PCNormals (24 bytes), so we will reseve 32 bytes
+    pipelineLayout = makePipelineLayout(device, setLayout, 32);
+    //tile size, workgroup shape and rows per thread are specialization constants 0..3
+    KernelSpec specExtract, specDown, specNormals;
+    makeKernelSpec(TILE_SIZE, profile.extract, specExtract);
+    makeKernelSpec(TILE_SIZE, profile.downsample, specDown);
+    makeKernelSpec(TILE_SIZE, profile.normals, specNormals);
     //create pipelines
-    VkPipeline pipeExtract = makeComputePipeline(device, pipelineLayout,
-        "../shaders/extract_tile.comp.spv", &modExtract);
-    VkPipeline pipeDownsample = makeComputePipeline(device, pipelineLayout,
-        "../shaders/downsample.comp.spv", &modDown);
+    pipeExtract = makeComputePipeline(device, pipelineLayout,
+        shaderPath("extract_tile.comp.spv"), &modExtract, &specExtract.info);
+    pipeDownsample = makeComputePipeline(device, pipelineLayout,
+        shaderPath("downsample.comp.spv"), &modDown, &specDown.info);
+    pipeMinMax = makeComputePipeline(device, pipelineLayout,
+        shaderPath("minmax.comp.spv"), &modMinMax);
+    if (args.bakeNormals) {
+        pipeNormals = makeComputePipeline(device, pipelineLayout,
+            shaderPath("normals.comp.spv"), &modNormals, &specNormals.info);
+    }
+    if (splat) {
+        SplatSpec specSplat;
+        makeSplatSpec(TILE_SIZE, profile.splat, splatRules, specSplat);
+        pipeSplat = makeComputePipeline(device, pipelineLayout,
+            shaderPath("splat.comp.spv"), &modSplat, &specSplat.info);
+    }
 
     // ---- 2) Create buffers. Put hmBuff info into GPU memory ----
     const VkMemoryPropertyFlags hostMem =
@@ -109,21 +234,36 @@ int runBuildCommand(VkDevice device,
 
     const VkDeviceSize hmBytes = sizeof(uint32_t) * (VkDeviceSize)hmW * (VkDeviceSize)hmH;
     const VkDeviceSize tileBytesMax = sizeof(uint32_t) * (VkDeviceSize)TILE_SIZE * (VkDeviceSize)TILE_SIZE;
-    //Giant map. Holds entire 256x256 heightmap. source
-    Buffer hmBuf  = createBuffer(device, physicalDevice, hmBytes,
+    //Giant map. Holds entire heightmap. source
+    hmBuf = createBuffer(device, physicalDevice, hmBytes,
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
-    //Has the small 256x256 cutout 
-    Buffer tileA  = createBuffer(device, physicalDevice, tileBytesMax,
+    //Has the small tile cutout 
+    tileA = createBuffer(device, physicalDevice, tileBytesMax,
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
     //LOD downsampling from tile A. GPU reads this
-    Buffer tileB  = createBuffer(device, physicalDevice, tileBytesMax,
+    tileB = createBuffer(device, physicalDevice, tileBytesMax,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    //min/max quadtree of one tile/LOD (at most 1365 nodes)
+    const VkDeviceSize minMaxBytes = sizeof(uint32_t) * (VkDeviceSize)minMaxNodeCount(MINMAX_MAX_LEVELS);
+    minMaxBuf = createBuffer(device, physicalDevice, minMaxBytes,
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    //Baked RGBA8 normal+slope pixels. Same size as a u32 tile
+    if (args.bakeNormals) {
+        normBuf = createBuffer(device, physicalDevice, tileBytesMax,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    }
+    //RGBA8 material weights. Same size as a u32 tile
+    if (splat) {
+        splatBuf = createBuffer(device, physicalDevice, tileBytesMax,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostMem);
+    }
 
     // upload hmU16 -> hmU32 -> hmBuf (easier for GPU when u32)
     std::vector<uint32_t> hmU32((size_t)hmW * (size_t)hmH);
-    for (size_t i = 0; i < hmU32.size(); i++) hmU32[i] = (uint32_t)hmU16[i];
+    widenU16ToU32(hmU16.data(), hmU16.size(), hmU32.data());
 
     {//Copy to GPU memory. Then unmap after. Block scope to make mapped local
+        TraceSpan span("upload_heightmap");
         void* mapped = nullptr;
         vkCheck(vkMapMemory(device, hmBuf.memory, 0, hmBytes, 0, &mapped), "vkMapMemory(heightmap)");
         std::memcpy(mapped, hmU32.data(), (size_t)hmBytes);
@@ -140,7 +280,6 @@ int runBuildCommand(VkDevice device,
     poolInfo.poolSizeCount = 1;
     poolInfo.pPoolSizes = &ps;
 
-    VkDescriptorPool descPool = VK_NULL_HANDLE;
     vkCheck(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descPool), "vkCreateDescriptorPool");
 
     VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
@@ -180,7 +319,6 @@ int runBuildCommand(VkDevice device,
     cpInfo.queueFamilyIndex = computeQueueFamily;
     cpInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
 
-    VkCommandPool cmdPool = VK_NULL_HANDLE;
     vkCheck(vkCreateCommandPool(device, &cpInfo, nullptr, &cmdPool), "vkCreateCommandPool");//get cmdPool
 
     VkCommandBufferAllocateInfo cbAlloc{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
@@ -191,6 +329,13 @@ int runBuildCommand(VkDevice device,
     VkCommandBuffer cmd = VK_NULL_HANDLE;
     vkCheck(vkAllocateCommandBuffers(device, &cbAlloc, &cmd), "vkAllocateCommandBuffers");
 
+    //whole map at once, before any tile is cut. never leaves the GPU
+    if (!args.filters.empty()) {
+        std::cout << "Filtering heightmap: " << args.filters.size() << " step(s)\n";
+        runTerrainFilters(device, physicalDevice, queue, cmdPool, setLayout, pipelineLayout,
+                          hmBuf, hmW, hmH, args.filters, args.filterParams);
+    }
+
     VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
 
     VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
@@ -202,69 +347,201 @@ int runBuildCommand(VkDevice device,
         vkCheck(vkQueueWaitIdle(queue), "vkQueueWaitIdle");
     };
 
-    // ---- 5) Tile loop ----
-    std::cout << "Building tiles: " << tilesX << " x " << tilesY
-              << " | LODs=" << args.lodCount << " | tileSize=256\n";
-    //If heightmap is 256x256 then there will be 16x16 = 256  workgorups. each workgroup has 16x16 threads which mean 65536 threads
-    for (uint32_t ty = 0; ty < tilesY; ty++) {
-        for (uint32_t tx = 0; tx < tilesX; tx++) {
-            const std::string tileDir = args.outDir + "/tiles/tile_" + std::to_string(tx) + "_" + std::to_string(ty);
-            ensureDir(tileDir);
+    // --trace only: 2 timestamps (before/after) per dispatch
+    double timestampPeriodNs = 0.0;
+    uint64_t timestampMask = ~0ull;
+    if (traceEnabled()) {
+        uint32_t qCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &qCount, nullptr);
+        std::vector<VkQueueFamilyProperties> qProps(qCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &qCount, qProps.data());
+        const uint32_t validBits = qProps[computeQueueFamily].timestampValidBits;
+
+        VkPhysicalDeviceProperties props{};
+        vkGetPhysicalDeviceProperties(physicalDevice, &props);
+        timestampPeriodNs = props.limits.timestampPeriod;
+
+        if (validBits > 0) {
+            if (validBits < 64) timestampMask = (1ull << validBits) - 1;
+            VkQueryPoolCreateInfo qpInfo{ VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+            qpInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+            qpInfo.queryCount = 2;
+            vkCheck(vkCreateQueryPool(device, &qpInfo, nullptr, &queryPool), "vkCreateQueryPool");
+        } else {
+            std::cerr << "[Warn] compute queue has no timestamps, trace will not have GPU times.\n";
+        }
+    }
 
-            // --- LOD0 extract: hmBuf -> tileA (256x256) ---
-            updateSet2Buffers(hmBuf.buffer, hmBytes, tileA.buffer, tileBytesMax);
+    // record one dispatch (pipeline + push constants) and wait for it
+    auto dispatchAndWait = [&](const char* name, TraceTile tile, VkPipeline pipe, const KernelConfig& cfg,
+                               const void* pc, uint32_t pcBytes, uint32_t size) {
+        TraceSpan span(name, tile);
+        vkCheck(vkResetCommandBuffer(cmd, 0), "vkResetCommandBuffer"); //clear and get new cmd
+        vkCheck(vkBeginCommandBuffer(cmd, &beginInfo), "vkBeginCommandBuffer");
 
-            PCExtract pcE{ hmW, tx, ty };
+        if (queryPool) {
+            vkCmdResetQueryPool(cmd, queryPool, 0, 2);
+            vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, 0);
+        }
 
-            vkCheck(vkResetCommandBuffer(cmd, 0), "vkResetCommandBuffer"); //clear and get new cmd
-            vkCheck(vkBeginCommandBuffer(cmd, &beginInfo), "vkBeginCommandBuffer");
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipe);//tell GPU with math program to run
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &set, 0, nullptr);
+        vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, pcBytes, pc);
 
-            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeExtract);//tell GPU with math program to run
-            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &set, 0, nullptr);
-            vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PCExtract), &pcE);
+        const uint32_t gx = kernelGroupsX(cfg, size); //groups needed so every x-axis px gets a thread
+        const uint32_t gy = kernelGroupsY(cfg, size); //y-axis: each thread covers cfg.rows px
+        vkCmdDispatch(cmd, gx, gy, 1); //Mecha-man disbatches **parallelism stage**
 
-            const uint32_t gx = ceilDiv(TILE_SIZE, LOCAL_X); //see how many group will be need if one thread will cover 16 x-axis px
-            const uint32_t gy = ceilDiv(TILE_SIZE, LOCAL_Y); //see how many group will be need if one thread will cover 16 y-axis px
-            vkCmdDispatch(cmd, gx, gy, 1); //Mecha-man disbatches **parallelism stage**
+        if (queryPool) vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, 1);
 
-            vkCheck(vkEndCommandBuffer(cmd), "vkEndCommandBuffer");
-            submitAndWait();
+        vkCheck(vkEndCommandBuffer(cmd), "vkEndCommandBuffer");
+        const uint64_t submitUs = queryPool ? traceNowUs() : 0;
+        submitAndWait();
 
-            // Read back LOD0 (256*256 u32) -> write u16 raw
-            std::vector<uint32_t> tileU32(TILE_SIZE * TILE_SIZE);
-            {
-                void* mapped = nullptr;
-                vkCheck(vkMapMemory(device, tileA.memory, 0, tileBytesMax, 0, &mapped), "vkMapMemory(tileA)");
-                std::memcpy(tileU32.data(), mapped, (size_t)tileBytesMax);
-                vkUnmapMemory(device, tileA.memory);
-            }
-            std::vector<uint16_t> tileOutU16(tileU32.size());
-            for (size_t i = 0; i < tileU32.size(); i++) tileOutU16[i] = (uint16_t)tileU32[i];
-            writeRawU16(tileDir + "/lod0.height.raw", tileOutU16); //write to disk
+        if (queryPool) { // GPU span starts at submit on the trace timeline, length is what the GPU measured
+            uint64_t ts[2]{};
+            vkCheck(vkGetQueryPoolResults(device, queryPool, 0, 2, sizeof(ts), ts, sizeof(uint64_t),
+                VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT), "vkGetQueryPoolResults");
+            const uint64_t ticks = ((ts[1] & timestampMask) - (ts[0] & timestampMask)) & timestampMask;
+            traceGpu(name, submitUs, (uint64_t)(double(ticks) * timestampPeriodNs / 1000.0), tile);
         }
-    }
-
-    // ---- 6) Cleanup ----
-    vkDestroyCommandPool(device, cmdPool, nullptr);
-    vkDestroyDescriptorPool(device, descPool, nullptr);
+    };
 
-    vkDestroyPipeline(device, pipeExtract, nullptr);
-    vkDestroyPipeline(device, pipeDownsample, nullptr);
-    vkDestroyShaderModule(device, modExtract, nullptr);
-    vkDestroyShaderModule(device, modDown, nullptr);
+    // copy count u32s out of a host visible buffer
+    auto readBack = [&](const Buffer& b, size_t count, std::vector<uint32_t>& out) {
+        TraceSpan span("readback");
+        out.resize(count);
+        void* mapped = nullptr;
+        vkCheck(vkMapMemory(device, b.memory, 0, count * sizeof(uint32_t), 0, &mapped), "vkMapMemory(readBack)");
+        std::memcpy(out.data(), mapped, count * sizeof(uint32_t));
+        vkUnmapMemory(device, b.memory);
+    };
 
-    vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
-    vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+    // --------------- encoder thread (PNG I/O) ---------------
+    BoundedQueue<ImageJob> encodeQ(8);
+    encodeQ.setTraceName("encodeQ");
+    std::exception_ptr exPtr = nullptr;
+    std::mutex exM;
+    std::thread encoder;
+    if (args.bakeNormals || splat) {
+        encoder = std::thread([&] {
+            traceThreadName("encoder");
+            try {
+                ImageJob j;
+                while (encodeQ.pop(j)) writeImageJob(j);
+            } catch (...) {
+                std::lock_guard<std::mutex> lk(exM);
+                if (!exPtr) exPtr = std::current_exception();
+                encodeQ.close();
+            }
+        });
+    }
 
-    vkDestroyBuffer(device, hmBuf.buffer, nullptr);
-    vkFreeMemory(device, hmBuf.memory, nullptr);
+    // ---- 5) Tile loop ----
+    std::cout << "Building tiles: " << tilesX << " x " << tilesY
+              << " | LODs=" << args.lodCount << " | tileSize=" << TILE_SIZE
+              << (args.bakeNormals ? " | baking normals" : "")
+              << (splat ? " | splat: " + std::to_string(splatRules.materials.size()) + " materials" : "") << "\n";
+    bool encoderClosed = false;
+    MinMaxIndex minMax;
+    minMax.tileSize = TILE_SIZE;
+    minMax.mapWidth = hmW;
+    minMax.mapHeight = hmH;
+    minMax.tilesX = tilesX;
+    minMax.tilesY = tilesY;
+    minMax.lodCount = args.lodCount;
+    //If heightmap is 256x256 then there will be 16x16 = 256  workgorups. each workgroup has 16x16 threads which mean 65536 threads
+    try {
+        for (const TileXY& t : mortonTileOrder(tilesX, tilesY)) { // Z-order, see morton.h
+            if (encoderClosed) break;
+            const uint32_t tx = t.x;
+            const uint32_t ty = t.y;
+            const std::string tileDir = args.outDir + "/tiles/tile_" + std::to_string(tx) + "_" + std::to_string(ty);
+            ensureDir(tileDir);
 
-    vkDestroyBuffer(device, tileA.buffer, nullptr);
-    vkFreeMemory(device, tileA.memory, nullptr);
+            // --- LOD0 extract: hmBuf -> tileA (TILE_SIZE^2) ---
+            updateSet2Buffers(hmBuf.buffer, hmBytes, tileA.buffer, tileBytesMax);
+            PCExtract pcE{ hmW, hmH, tx, ty };
+            dispatchAndWait("extract_tile", TraceTile{ tx, ty, 0 }, pipeExtract, profile.extract, &pcE, sizeof(PCExtract), TILE_SIZE);
+
+            // --- LOD chain: cur -> next (half size), ping-pong tileA/tileB ---
+            Buffer* cur = &tileA;
+            Buffer* next = &tileB;
+            std::vector<uint32_t> tileU32;
+            std::vector<uint32_t> nodes;
+            std::vector<uint16_t> tileOutU16;
+            for (uint32_t lod = 0; lod < args.lodCount; lod++) {
+                const uint32_t size = TILE_SIZE >> lod; // never 0, lodCount is checked up top
+
+                if (lod > 0) {
+                    updateSet2Buffers(cur->buffer, tileBytesMax, next->buffer, tileBytesMax);
+                    PCDownsample pcD{ size * 2 };
+                    dispatchAndWait("downsample", TraceTile{ tx, ty, lod }, pipeDownsample, profile.downsample, &pcD, sizeof(PCDownsample), size);
+                    std::swap(cur, next);
+                }
+
+                // --- min/max quadtree: cur -> minMaxBuf, a single 16x16 workgroup ---
+                const uint32_t levels = minMaxLevels(size);
+                updateSet2Buffers(cur->buffer, tileBytesMax, minMaxBuf.buffer, minMaxBytes);
+                PCMinMax pcM{ size, levels };
+                dispatchAndWait("minmax", TraceTile{ tx, ty, lod }, pipeMinMax, MINMAX_GROUP, &pcM, sizeof(PCMinMax), MINMAX_GROUP.localX);
+                readBack(minMaxBuf, minMaxNodeCount(levels), nodes);
+                minMax.add(tx, ty, lod, levels, nodes.data());
+
+                // Read back LOD (size*size u32) -> write u16 raw
+                readBack(*cur, (size_t)size * size, tileU32);
+                tileOutU16.resize(tileU32.size());
+                narrowU32ToU16(tileU32.data(), tileU32.size(), tileOutU16.data());
+                {
+                    TraceSpan span("write_raw", TraceTile{ tx, ty, lod });
+                    writeRawU16(tileDir + "/lod" + std::to_string(lod) + ".height.raw", tileOutU16); //write to disk
+                }
+
+                // normals and splat take the same push constants
+                PCNormals pcN{ hmW, hmH, tx, ty, 1u << lod, args.normalStrength };
+
+                if (args.bakeNormals) {
+                    // --- normals: hmBuf (neighbor tiles included) -> normBuf, then hand off to encoder ---
+                    updateSet2Buffers(hmBuf.buffer, hmBytes, normBuf.buffer, tileBytesMax);
+                    dispatchAndWait("normals", TraceTile{ tx, ty, lod }, pipeNormals, profile.normals, &pcN, sizeof(PCNormals), size);
+
+                    ImageJob j;
+                    j.normalPath = tileDir + "/lod" + std::to_string(lod) + ".normal.png";
+                    j.slopePath = tileDir + "/lod" + std::to_string(lod) + ".slope.png";
+                    j.size = size;
+                    j.tile = TraceTile{ tx, ty, lod };
+                    readBack(normBuf, (size_t)size * size, j.px);
+                    if (!encodeQ.push(std::move(j))) { encoderClosed = true; break; } // encoder hit an error
+                }
+
+                if (splat) {
+                    // --- splat: hmBuf -> splatBuf (material weights), encoded on the same thread ---
+                    updateSet2Buffers(hmBuf.buffer, hmBytes, splatBuf.buffer, tileBytesMax);
+                    dispatchAndWait("splat", TraceTile{ tx, ty, lod }, pipeSplat, profile.splat, &pcN, sizeof(PCNormals), size);
+
+                    ImageJob j;
+                    j.splatPath = tileDir + "/lod" + std::to_string(lod) + ".splat.png";
+                    j.size = size;
+                    j.tile = TraceTile{ tx, ty, lod };
+                    readBack(splatBuf, (size_t)size * size, j.px);
+                    if (!encodeQ.push(std::move(j))) { encoderClosed = true; break; }
+                }
+            }
+        }
+        if (!encoderClosed) {
+            TraceSpan span("write_minmax_index");
+            writeMinMaxIndex(args.outDir + "/minmax.index", minMax);
+        }
+    } catch (...) {
+        std::lock_guard<std::mutex> lk(exM);
+        if (!exPtr) exPtr = std::current_exception();
+    }
 
-    vkDestroyBuffer(device, tileB.buffer, nullptr);
-    vkFreeMemory(device, tileB.memory, nullptr);
+    // let the encoder drain what is left. errors are rethrown here, the cleanup guard still runs
+    encodeQ.close();
+    if (encoder.joinable()) encoder.join();
 
+    if (exPtr) std::rethrow_exception(exPtr);
     std::cout << "Build done: " << args.outDir << "\n";
     return 0;
 }
@@ -1,12 +1,25 @@
 #pragma once
+#include "kernel_profile.h"
+#include "terrain_filter.h"
+
 #include <vulkan/vulkan.h>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 struct BuildArgs {
     std::string heightmapPath;
     std::string outDir;
     uint32_t lodCount = 5;
+    uint32_t tileSize = 256;      // power of two, 64..1024. big = fewer dispatches, small = finer streaming
+    std::string profilePath = DEFAULT_PROFILE_PATH; // autotune output. no entry for this GPU = 16x16 workgroups
+
+    std::vector<FilterStep> filters; // --filter smooth:2,thermal:50,... run on the GPU before tiling. empty = none
+    TerrainFilterParams filterParams;
+
+    bool bakeNormals = false;     // write lodN.normal.png + lodN.slope.png per tile
+    float normalStrength = 100.0f; // height scale / spacing, same ratio as export_mesh --scale/--spacing
+    std::string splatRulesPath;    // --splat rules.json: lodN.splat.png material masks per tile (splat_rules.h). empty = off
 };
 
 int runBuildCommand(VkDevice device,
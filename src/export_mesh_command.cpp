@@ -1,4 +1,12 @@
 #include "export_mesh_command.h"
+#include "bounded_queue.h"
+#include "rtin_mesh.h"
+#include "mesh_merge.h"
+#include "heightmap_io.h"
+#include "mesh_util.h"
+#include "minmax_index.h"
+#include "morton.h"
+#include "trace.h"
 
 #include <filesystem>
 #include <fstream>
@@ -9,24 +17,43 @@
 
 #include <thread>
 #include <mutex>
-#include <condition_variable>
-#include <deque>
 #include <atomic>
 #include <exception>
 #include <algorithm>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <unordered_map>
 /*
 1) find the file and make new dir if needed , find raw file 
-2) jobs thread(push a job for each .raw file)
-3) worker thread(read heights and build mesh)
+2) jobs thread(push a job for each .raw file). --region drops tiles outside the box, --camera picks each
+   tile's LOD from its distance (--lod-distances) and sorts the jobs nearest first.
+   otherwise jobs go out in Morton (Z) order, so a worker's neighbour border reads hit tiles
+   another worker just read (still in the page cache)
+3) worker thread(read heights and build mesh. full grid, or RTIN when --max-error is given.
+   skirts on edges whose neighbour got another LOD)
 4) writer thread(Write OBJ) 
+5) (--merge) weld the kept tile meshes into one mesh per chunk, in parallel, and hand those to the writer
 
  the bounded buffers used and their producer and consumer are as follows:
- jobs -> [jobQ 64] -> workers -> [writeQ 16] -> writer
+ jobs -> [jobQ 64] -> workers -> [writeQ 2..16] -> writer
+ with --merge: workers -> meshes (kept in memory) -> merge -> [writeQ 2..16] -> writer
+ (writeQ holds 16 tiles of 256, fewer of the bigger tile sizes, so queued meshes stay about the same bytes)
+
+ tile heights/vertices/indices live in a fixed set of TileBuffers (the pool, itself a bounded buffer):
+ writer -> [pool] -> workers. a worker takes one before reading a tile and the writer gives it back
+ after the OBJ is written, so once every buffer has grown to a full tile the loop stops allocating.
+ with --merge the mesh is copied out (exact size) so the pooled buffer keeps its capacity.
+ an empty pool also means the writer is behind, so workers wait there (back-pressure)
+
+ every tile mesh is (N+1)x(N+1): the tile plus the first row/column of its east/south
+ neighbour, placed N * spacing apart. so neighbours share their border points exactly.
+ the padded edge tiles of a map that isn't a multiple of N are trimmed back to the map size
+ recorded in minmax.index (trimTileMesh)
 
  each have while loop that only stops when a buffer is closed
 */
 
-static constexpr uint32_t TILE0_SIZE = 256;
 //helpers
 static void ensureDir(const std::string& path) {
     std::filesystem::create_directories(std::filesystem::path(path));
@@ -34,30 +61,6 @@ static void ensureDir(const std::string& path) {
 static bool fileExists(const std::string& path) {
     return std::filesystem::exists(std::filesystem::path(path));
 }
-static std::vector<uint16_t> readRawU16(const std::string& path, size_t count) {
-    std::vector<uint16_t> data(count);
-    std::ifstream f(path, std::ios::binary);
-    if (!f) throw std::runtime_error("Failed to open: " + path);
-
-    f.read(reinterpret_cast<char*>(data.data()),
-           static_cast<std::streamsize>(count * sizeof(uint16_t)));
-    if (!f) throw std::runtime_error("Failed to read enough bytes: " + path);
-    return data;
-}
-//helper to write OBJ files
-static void writeOBJ(const std::string& path, const std::vector<float>& vertsXYZ, const std::vector<uint32_t>& indices)
-{
-    std::ofstream o(path);
-    if (!o) throw std::runtime_error("Failed to write: " + path);
-
-    for (size_t i = 0; i < vertsXYZ.size(); i += 3) {
-        o << "v " << vertsXYZ[i] << " " << vertsXYZ[i + 1] << " " << vertsXYZ[i + 2] << "\n";
-    }
-    for (size_t i = 0; i < indices.size(); i += 3) {
-        o << "f " << (indices[i] + 1) << " " << (indices[i + 1] + 1) << " " << (indices[i + 2] + 1) << "\n";
-    }
-}
-
 // Parse "tile_X_Y" -> (X, Y). Returns false if format unexpected.
 static bool parseTileXY(const std::string& folderName, uint32_t& tx, uint32_t& ty) {
     const std::string prefix = "tile_"; //check tiles_0_0 folder in world
@@ -77,111 +80,181 @@ static bool parseTileXY(const std::string& folderName, uint32_t& tx, uint32_t& t
     }
 }
 
-static void buildGridMeshFromHeightU16(const std::vector<uint16_t>& h, uint32_t N, float spacing,
-                                       float heightScale, uint32_t tileX, uint32_t tileY,
-                                       std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx)
-{
-    outVertsXYZ.clear();
-    outVertsXYZ.resize(static_cast<size_t>(N) * N * 3);
+// --- jobs ---
+struct ExportJob {
+    std::string tileFolderName; // "tile_X_Y"
+    std::string tileDirPath;    // full path to that tile directory
+    uint32_t tileX = 0;
+    uint32_t tileY = 0;
+    uint32_t lod = 0;
+    float distance = 0.0f; // to --camera
+};
+// everything one tile needs. n = biggest grid in use (N >> finest LOD): heights are reserved for
+// (n+1)x(n+1) up front, and the full grid mesh when that is the mesher. RTIN meshes are much smaller
+// than the grid, so those grow on first use instead
+struct TileBuffers {
+    std::vector<uint16_t> heights;
+    std::vector<float> verts;
+    std::vector<uint32_t> idx;
+    std::vector<uint32_t> vertGrid; // grid mesh only: z * (n+1) + x per vertex, for --merge and edge trimming
+    RtinScratch rtin; // --max-error only, grows on first use
+
+    TileBuffers(uint32_t n, bool gridMesh) {
+        const size_t G = (size_t)n + 1;
+        heights.reserve(G * G);
+        if (!gridMesh) return;
+        verts.reserve(G * G * 3);
+        idx.reserve((size_t)n * n * 6);
+    }
+};
+struct WriteJob {
+    std::string outObjPath;
+    std::unique_ptr<TileBuffers> buf; // verts + idx to write. back to the pool afterwards
+    TraceTile tile; // --trace only
+};
 
-    const float tileWorldStride = float(TILE0_SIZE - 1) * spacing; //calc world position
-    const float baseX = tileWorldStride * float(tileX);
-    const float baseZ = tileWorldStride * float(tileY);
+static void setExceptionOnce(std::exception_ptr& dst, std::mutex& m, std::exception_ptr e) {
+    std::lock_guard<std::mutex> lk(m);
+    if (!dst) dst = e;
+}
 
-    //for all Vertices in x in z
-    for (uint32_t z = 0; z < N; z++) {
-        for (uint32_t x = 0; x < N; x++) {
-            const uint32_t i = z * N + x;
+// the writer thread can still set it while the main thread looks
+static bool hasException(const std::exception_ptr& ex, std::mutex& m) {
+    std::lock_guard<std::mutex> lk(m);
+    return ex != nullptr;
+}
 
-            float px = float(x) * spacing + baseX; //horizontal plane
-            float pz = float(z) * spacing + baseZ;
+// split the tile grid into chunks x chunks groups, weld each group and queue it for the writer
+static void mergeChunks(const std::vector<TileMesh>& meshes, uint32_t N, const ExportMeshArgs& args,
+                        uint32_t threadCount, BoundedQueue<WriteJob>& writeQ, std::atomic<size_t>& weldedVerts)
+{
+    if (meshes.empty()) return;
+    uint32_t tilesX = 0, tilesY = 0;
+    for (const auto& m : meshes) {
+        tilesX = std::max(tilesX, m.tileX + 1);
+        tilesY = std::max(tilesY, m.tileY + 1);
+    }
+    const uint32_t chunks = std::max(1u, args.chunks);
+    const uint32_t chunkW = (tilesX + chunks - 1) / chunks; //tiles per chunk
+    const uint32_t chunkH = (tilesY + chunks - 1) / chunks;
 
-            float yn = float(h[i]) / 65535.0f;   //Vertical plane. (Height is Normalized since in a heightmap, height = intensity)
-            float py = yn * heightScale;
+    std::vector<std::vector<const TileMesh*>> groups((size_t)chunks * chunks);
+    for (const auto& m : meshes) groups[(size_t)(m.tileY / chunkH) * chunks + (m.tileX / chunkW)].push_back(&m);
 
-            const size_t vi = (size_t)i * 3; //store the data in the array
-            outVertsXYZ[vi + 0] = px;
-            outVertsXYZ[vi + 1] = py;
-            outVertsXYZ[vi + 2] = pz;
-        }
-    }
+    for (uint32_t cy = 0; cy < chunks; cy++) {
+        for (uint32_t cx = 0; cx < chunks; cx++) {
+            const auto& group = groups[(size_t)cy * chunks + cx];
+            if (group.empty()) continue;
 
-    outIdx.clear();
-    outIdx.reserve(static_cast<size_t>(N - 1) * (N - 1) * 6);//tell how much mem to reserve for output. 2 triangles each quad. 6 points
-    
-    //for all Vertices in x in z
-    for (uint32_t z = 0; z < N - 1; z++) {
-        for (uint32_t x = 0; x < N - 1; x++) {
-            uint32_t i0 = z * N + x;        //top left triangle
-            uint32_t i1 = z * N + (x + 1);  //top right triangle
-            uint32_t i2 = (z + 1) * N + x;  //bottom left triangle
-            uint32_t i3 = (z + 1) * N + (x + 1);//bottom right triangle
-
-            outIdx.push_back(i0); outIdx.push_back(i2); outIdx.push_back(i1);//add these numbers at the very end of the list
-            outIdx.push_back(i1); outIdx.push_back(i2); outIdx.push_back(i3);
+            WriteJob wj;
+            wj.outObjPath = args.outDir + (chunks == 1 ? std::string("/world_lod0.obj")
+                : "/world_chunk_" + std::to_string(cx) + "_" + std::to_string(cy) + "_lod0.obj");
+            wj.buf = std::make_unique<TileBuffers>(0, false); // not pooled, sized by the merge
+            {
+                TraceSpan span("merge_chunk", TraceTile{ cx, cy });
+                mergeTileMeshes(group, N, threadCount, wj.buf->verts, wj.buf->idx);
+            }
+            weldedVerts.fetch_add(wj.buf->verts.size() / 3, std::memory_order_relaxed);
+            if (!writeQ.push(std::move(wj))) return; // writer failed
         }
     }
 }
 
-// --- Bounded Buffer ---
-template <typename T>
-class BoundedQueue {
-public:
-    explicit BoundedQueue(size_t cap) : cap_(cap) {}
-
-    // blocks if full returns false if closed
-    bool push(T item) {
-        std::unique_lock<std::mutex> lk(m_);//wait(mutex)
-        cvNotFull_.wait(lk, [&] { return closed_ || q_.size() < cap_; }); //if predicate is true, go immediately. Else sleep.//wait(empty)
-        if (closed_) return false;
-        q_.push_back(std::move(item));  //Critical section. Writes to buffer
-        cvNotEmpty_.notify_one();       //signal(full)
-        return true;                    //mutex automatically signals. signal(mutex)
+// build --tile-size, from the first tile's lod0.height.raw (every tile has the same size)
+static uint32_t detectTileSize(const std::string& tilesDir) {
+    for (const auto& entry : std::filesystem::directory_iterator(tilesDir)) {
+        uint32_t tx = 0, ty = 0;
+        if (!entry.is_directory() || !parseTileXY(entry.path().filename().string(), tx, ty)) continue;
+        const std::string path = entry.path().string() + "/lod0.height.raw";
+        if (!fileExists(path)) continue;
+        const uint32_t size = rawTileSize(path);
+        if (size < 2 || (size & (size - 1)) != 0) throw std::runtime_error("Not a power of two u16 tile: " + path);
+        return size;
     }
+    throw std::runtime_error("No lod0.height.raw under: " + tilesDir);
+}
 
-    // blocks if empty; returns false if empty+closed
-    bool pop(T& out) {
-        std::unique_lock<std::mutex> lk(m_);//wait(mutex)
-        cvNotEmpty_.wait(lk, [&] { return closed_ || !q_.empty(); });//if predicate is true, go immediately. Else sleep.//wait(full)
-        if (q_.empty()) return false; // closed + empty
-        out = std::move(q_.front());
-        q_.pop_front();
-        cvNotFull_.notify_one();       //signal(empty)
-        return true;                //mutex automatically signals. signal(mutex)
-    }
+// last grid column (row) of tile t that still has map under it: n for whole tiles, less for the edge
+// tiles build padded up to N (the map size comes from minmax.index, 0 = unknown so keep everything)
+static uint32_t lastGridLine(uint32_t mapSize, uint32_t t, uint32_t N, uint32_t lod) {
+    const uint32_t n = N >> lod;
+    const uint64_t start = (uint64_t)t * N;
+    if (mapSize == 0 || start + N <= mapSize) return n;
+    const uint32_t valid = start < mapSize ? uint32_t(mapSize - start) : 1u; // real LOD0 pixels in the tile
+    // first LODn column made only of padding. it (and everything after) repeats the last real column
+    return std::min(n, std::max(1u, (valid + (1u << lod) - 1) >> lod));
+}
 
-    void close() {
-        std::lock_guard<std::mutex> lk(m_);
-        closed_ = true;
-        cvNotEmpty_.notify_all();
-        cvNotFull_.notify_all();
+// distance from p to the box [lo, hi] (0 inside)
+static float distanceToBox(const float p[3], const float lo[3], const float hi[3]) {
+    float d2 = 0.0f;
+    for (int i = 0; i < 3; i++) {
+        const float d = std::max({ lo[i] - p[i], 0.0f, p[i] - hi[i] });
+        d2 += d * d;
     }
+    return std::sqrt(d2);
+}
 
-private:
-    size_t cap_;
-    std::deque<T> q_;
-    bool closed_ = false;
-    std::mutex m_;
-    std::condition_variable cvNotEmpty_;
-    std::condition_variable cvNotFull_;
-};
+// ---- 2) every tile_X_Y folder -> one job. region filter, LOD choice and nearest first order ----
+static std::vector<ExportJob> collectJobs(const std::string& tilesDir, const ExportMeshArgs& args, uint32_t N) {
+    if (!args.region.empty() && args.region.size() != 4) throw std::runtime_error("--region needs x0,z0,x1,z1.");
+    if (!args.camera.empty() && args.camera.size() != 3) throw std::runtime_error("--camera needs x,y,z.");
+    if (!args.lodDistances.empty() && args.camera.empty()) throw std::runtime_error("--lod-distances needs --camera.");
+    if (!args.lodDistances.empty() && args.merge) throw std::runtime_error("--merge needs every tile at the same LOD (drop --lod-distances).");
+
+    // tile height ranges from build's minmax.index, so the camera distance is to the real terrain box
+    MinMaxIndex bounds;
+    const std::string indexPath = args.inDir + "/minmax.index";
+    if (!args.camera.empty() && fileExists(indexPath)) bounds = readMinMaxIndex(indexPath);
+
+    const float stride = float(N) * args.spacing; // tile footprint in world units
+    std::vector<ExportJob> jobs;
+    for (const auto& entry : std::filesystem::directory_iterator(tilesDir)) {// for all files
+        if (!entry.is_directory()) continue;
+
+        const std::string folderName = entry.path().filename().string();
+        uint32_t tileX = 0, tileY = 0;
+        if (!parseTileXY(folderName, tileX, tileY)) continue;
+
+        const float x0 = stride * float(tileX), z0 = stride * float(tileY);
+        const float x1 = x0 + stride, z1 = z0 + stride;
+        if (!args.region.empty()) {
+            const float rx0 = std::min(args.region[0], args.region[2]), rx1 = std::max(args.region[0], args.region[2]);
+            const float rz0 = std::min(args.region[1], args.region[3]), rz1 = std::max(args.region[1], args.region[3]);
+            if (x1 < rx0 || x0 > rx1 || z1 < rz0 || z0 > rz1) continue;
+        }
 
-// --- jobs ---
-struct ExportJob {
-    std::string tileFolderName; // "tile_X_Y"
-    std::string tileDirPath;    // full path to that tile directory
-    uint32_t tileX = 0;
-    uint32_t tileY = 0;
-};
-struct WriteJob {
-    std::string outObjPath;
-    std::vector<float> verts;
-    std::vector<uint32_t> idx;
-};
+        ExportJob j;
+        j.tileFolderName = folderName;
+        j.tileDirPath = entry.path().string();
+        j.tileX = tileX;
+        j.tileY = tileY;
+
+        if (!args.camera.empty()) {
+            float lo[3] = { x0, 0.0f, z0 };
+            float hi[3] = { x1, args.heightScale, z1 };
+            if (const MinMaxEntry* e = bounds.find(tileX, tileY, 0)) {
+                lo[1] = float(e->minH) / 65535.0f * args.heightScale;
+                hi[1] = float(e->maxH) / 65535.0f * args.heightScale;
+            }
+            j.distance = distanceToBox(args.camera.data(), lo, hi);
 
-static void setExceptionOnce(std::exception_ptr& dst, std::mutex& m, std::exception_ptr e) {
-    std::lock_guard<std::mutex> lk(m);
-    if (!dst) dst = e;
+            while (j.lod < args.lodDistances.size() && j.distance >= args.lodDistances[j.lod]) j.lod++;
+            // never coarser than what build made, and keep at least a 2x2 grid for the mesh
+            while (j.lod > 0 && ((N >> j.lod) < 2 ||
+                   !fileExists(j.tileDirPath + "/lod" + std::to_string(j.lod) + ".height.raw"))) j.lod--;
+        }
+        jobs.push_back(std::move(j));
+    }
+
+    // Z-order first (directory order is whatever the filesystem likes), then nearest first keeping Z-order for ties
+    std::sort(jobs.begin(), jobs.end(), [](const ExportJob& a, const ExportJob& b) {
+        return mortonEncode(a.tileX, a.tileY) < mortonEncode(b.tileX, b.tileY);
+    });
+    if (!args.camera.empty()) {
+        std::stable_sort(jobs.begin(), jobs.end(), [](const ExportJob& a, const ExportJob& b) { return a.distance < b.distance; });
+    }
+    return jobs;
 }
 
 //function to run export mesh command
@@ -193,82 +266,191 @@ int runExportMeshCommand(const ExportMeshArgs& args) {
     }
     ensureDir(args.outDir);
 
-    // Export only LOD0 
-    const uint32_t lod = 0;
-    const uint32_t N = TILE0_SIZE; // 256
-    //jobQ has 64 spaces. writeQ has 16 spaces
+    // tile size at lod0 (build --tile-size), N >> lod after that
+    std::vector<ExportJob> jobs;
+    uint32_t N = 0;
+    {
+        TraceSpan span("collect_jobs");
+        N = detectTileSize(tilesDir);
+        jobs = collectJobs(tilesDir, args, N);
+    }
+    // real heightmap size, so edge tiles stop where the map does (without an index: whole tiles)
+    uint32_t mapWidth = 0, mapHeight = 0;
+    if (fileExists(args.inDir + "/minmax.index")) {
+        const MinMaxIndex header = readMinMaxIndexHeader(args.inDir + "/minmax.index");
+        mapWidth = header.mapWidth;
+        mapHeight = header.mapHeight;
+    }
+    //jobQ has 64 spaces. writeQ has 16 spaces for 256 tiles, scaled down for bigger ones (min 2)
+    const size_t writeDepth = std::clamp<size_t>((size_t)16 * 256 * 256 / ((size_t)N * N), 2, 16);
     BoundedQueue<ExportJob> jobQ(64);
-    BoundedQueue<WriteJob>  writeQ(16);
+    BoundedQueue<WriteJob>  writeQ(writeDepth);
+    jobQ.setTraceName("jobQ");
+    writeQ.setTraceName("writeQ");
+
+    // RTIN tables are per grid size (one per LOD in use), built once and shared (read only) by all workers
+    const bool simplify = args.maxError >= 0.0f;
+    std::vector<std::unique_ptr<RtinTriangulator>> rtins;
+    if (simplify) {
+        for (const auto& j : jobs) {
+            if (j.lod >= rtins.size()) rtins.resize(j.lod + 1);
+            if (!rtins[j.lod]) rtins[j.lod] = std::make_unique<RtinTriangulator>((N >> j.lod) + 1);
+        }
+    }
+
+    uint32_t hw = std::thread::hardware_concurrency();//how many worker threads can the CPU take?
+    if (hw == 0) hw = 4;
+    const uint32_t workerCount = std::max(1u, hw - 1u); //one less thread just can case
+
+    // --lod-distances: LOD of every exported tile, so a tile can tell which neighbours use another one
+    std::unordered_map<uint64_t, uint32_t> lodOf;
+    if (!args.lodDistances.empty()) {
+        for (const auto& j : jobs) lodOf[mortonEncode(j.tileX, j.tileY)] = j.lod;
+    }
+
+    // enough buffers for a full writeQ, one being written and one per worker, sized for the finest LOD in use
+    uint32_t finestLod = UINT32_MAX;
+    for (const auto& j : jobs) finestLod = std::min(finestLod, j.lod);
+    const uint32_t nMax = jobs.empty() ? 0 : N >> finestLod;
+    const size_t poolSize = writeDepth + 1 + workerCount;
+    BoundedQueue<std::unique_ptr<TileBuffers>> pool(poolSize);
+    pool.setTraceName("pool");
+    for (size_t i = 0; i < poolSize; i++) pool.push(std::make_unique<TileBuffers>(nMax, !simplify));
 
     std::atomic<size_t> exported{0};
+    std::atomic<size_t> triangles{0};
+    std::atomic<size_t> weldedVerts{0};
+    std::vector<TileMesh> meshes; // --merge only
+    std::mutex meshesM;
     std::exception_ptr exPtr = nullptr;
     std::mutex exM;
 
     // --------------- writer thread (I/O) ---------------
     std::thread writer([&] {
+        traceThreadName("writer");
         try {           //pop from writeQ and write
             WriteJob wj;
             while (writeQ.pop(wj)) { //LOOP 
-                writeOBJ(wj.outObjPath, wj.verts, wj.idx);
+                {
+                    TraceSpan span("write_obj", wj.tile);
+                    writeOBJ(wj.outObjPath, wj.buf->verts, wj.buf->idx);
+                }
                 exported.fetch_add(1, std::memory_order_relaxed);
+                pool.push(std::move(wj.buf)); // closed once the workers are done, then it's just freed
             }
         } catch (...) {
             setExceptionOnce(exPtr, exM, std::current_exception());
             jobQ.close();
             writeQ.close();
+            pool.close();
         }
     });
 
     // --------------- worker threads (CPU compute) ---------------
-    uint32_t hw = std::thread::hardware_concurrency();//how many worker threads can the CPU take?
-    if (hw == 0) hw = 4;
-    const uint32_t workerCount = std::max(1u, hw - 1u); //one less thread just can case
     std::vector<std::thread> workers;   
     workers.reserve(workerCount);       //reserve, alloc space
 
     for (uint32_t t = 0; t < workerCount; t++) {
         workers.emplace_back([&] {
+            traceThreadName("worker");
             try {
                 ExportJob j;
                 while (jobQ.pop(j)) { 
-                    const std::string hPath = j.tileDirPath + "/lod0.height.raw";
+                    const std::string heightFile = "lod" + std::to_string(j.lod) + ".height.raw";
+                    const std::string hPath = j.tileDirPath + "/" + heightFile;
                     if (!fileExists(hPath)) continue;
 
-                    auto h = readRawU16(hPath, static_cast<size_t>(N) * N); //calc height data
-                    WriteJob wj;
-                    wj.outObjPath = args.outDir + "/" + j.tileFolderName + "_lod0.obj";
-
-                    buildGridMeshFromHeightU16(h, N, args.spacing, args.heightScale, j.tileX, j.tileY, wj.verts, wj.idx);
+                    // lodN pixels are 2^lod lod0 pixels apart, so the tile still covers the same ground
+                    const uint32_t n = N >> j.lod;
+                    const float spacing = args.spacing * float(1u << j.lod);
+
+                    const TraceTile tt{ j.tileX, j.tileY, j.lod };
+                    std::unique_ptr<TileBuffers> buf;
+                    if (!pool.pop(buf)) break; // waits while the writer is behind. closed on error
+                    const std::vector<uint16_t>& h = buf->heights;
+                    {   // (n+1)x(n+1) with neighbour borders so edges line up with the next tile
+                        TraceSpan span("read_tile", tt);
+                        readTileWithBorderU16(tilesDir, j.tileX, j.tileY, heightFile, n, buf->heights); //calc height data
+                    }
+                    const float stride = float(N) * args.spacing; //calc world position
+                    const float baseX = stride * float(j.tileX);
+                    const float baseZ = stride * float(j.tileY);
+
+                    if (simplify) {
+                        TraceSpan span("mesh_rtin", tt);
+                        buildRtinMeshFromHeightU16(*rtins[j.lod], h, spacing, args.heightScale, baseX, baseZ,
+                                                   args.maxError, buf->verts, buf->idx, buf->rtin);
+                    } else {
+                        TraceSpan span("mesh_grid", tt);
+                        buildGridMeshFromHeightU16(h, n + 1, spacing, args.heightScale, baseX, baseZ, buf->verts, buf->idx);
+                    }
+                    // padded edge tile (lastX/lastZ < n) and --lod-distances neighbours on another LOD (skirts)
+                    const uint32_t lastX = lastGridLine(mapWidth, j.tileX, N, j.lod);
+                    const uint32_t lastZ = lastGridLine(mapHeight, j.tileY, N, j.lod);
+                    uint32_t skirtEdges = 0;
+                    if (!lodOf.empty()) {
+                        auto otherLod = [&](int64_t x, int64_t y) {
+                            if (x < 0 || y < 0) return false;
+                            auto it = lodOf.find(mortonEncode((uint32_t)x, (uint32_t)y));
+                            return it != lodOf.end() && it->second != j.lod;
+                        };
+                        if (otherLod((int64_t)j.tileX - 1, j.tileY)) skirtEdges |= EDGE_WEST;
+                        if (otherLod((int64_t)j.tileX + 1, j.tileY)) skirtEdges |= EDGE_EAST;
+                        if (otherLod(j.tileX, (int64_t)j.tileY - 1)) skirtEdges |= EDGE_NORTH;
+                        if (otherLod(j.tileX, (int64_t)j.tileY + 1)) skirtEdges |= EDGE_SOUTH;
+                    }
+
+                    std::vector<uint32_t>& vertGrid = simplify ? buf->rtin.vertGrid : buf->vertGrid;
+                    if (!simplify && (args.merge || lastX < n || lastZ < n || skirtEdges)) {
+                        vertGrid.resize(buf->verts.size() / 3);
+                        std::iota(vertGrid.begin(), vertGrid.end(), 0u);
+                    }
+                    if (lastX < n || lastZ < n) {
+                        TraceSpan span("trim_edge", tt);
+                        trimTileMesh(n + 1, lastX, lastZ, spacing, baseX, baseZ, buf->verts, buf->idx, vertGrid);
+                    }
+                    if (skirtEdges) {
+                        // deeper than any gap the two LODs can leave: the tile's own height range (border included)
+                        TraceSpan span("skirts", tt);
+                        const auto [lo, hi] = std::minmax_element(h.begin(), h.end());
+                        const float depth = std::max(float(*hi - *lo) / 65535.0f * args.heightScale, spacing);
+                        addTileSkirts(n + 1, skirtEdges, depth, buf->verts, buf->idx, vertGrid);
+                    }
+                    triangles.fetch_add(buf->idx.size() / 3, std::memory_order_relaxed);
+
+                    if (args.merge) { //keep it for step 5. the mesh is copied out, the buffer (and its capacity) goes straight back
+                        TileMesh tm;
+                        tm.tileX = j.tileX;
+                        tm.tileY = j.tileY;
+                        tm.verts.assign(buf->verts.begin(), buf->verts.end());
+                        tm.idx.assign(buf->idx.begin(), buf->idx.end());
+                        tm.vertGrid.assign(vertGrid.begin(), vertGrid.end());
+                        {
+                            std::lock_guard<std::mutex> lk(meshesM);
+                            meshes.push_back(std::move(tm));
+                        }
+                        pool.push(std::move(buf));
+                        continue;
+                    }
 
+                    WriteJob wj;
+                    wj.outObjPath = args.outDir + "/" + j.tileFolderName + "_lod" + std::to_string(j.lod) + ".obj";
+                    wj.buf = std::move(buf);
+                    wj.tile = tt;
                     if (!writeQ.push(std::move(wj))) break; // writer stopped/closed. push to writeQ
                 }
             } catch (...) {
                 setExceptionOnce(exPtr, exM, std::current_exception());
                 jobQ.close();
                 writeQ.close();
+                pool.close();
             }
         });
     }
 
     // --------------- jobs (main thread, producer) ---------------
-    try {
-        for (const auto& entry : std::filesystem::directory_iterator(tilesDir)) {// for all files
-            if (!entry.is_directory()) continue;
-
-            const std::string folderName = entry.path().filename().string();
-            uint32_t tileX = 0, tileY = 0;
-            if (!parseTileXY(folderName, tileX, tileY)) continue;
-
-            ExportJob j;
-            j.tileFolderName = folderName;
-            j.tileDirPath = entry.path().string();
-            j.tileX = tileX;
-            j.tileY = tileY;
-
-            if (!jobQ.push(std::move(j))) break; // closed due to error. else, push to jobQ
-        }
-    } catch (...) {
-        setExceptionOnce(exPtr, exM, std::current_exception());
+    for (auto& j : jobs) {
+        if (!jobQ.push(std::move(j))) break; // closed due to error. else, push to jobQ
     }
 
     // signal no more jobs
@@ -276,13 +458,27 @@ int runExportMeshCommand(const ExportMeshArgs& args) {
 
     // join workers then close writer queue
     for (auto& th : workers) th.join();
+    pool.close();
+
+    // --------------- 5) merge (main thread + workerCount helpers) ---------------
+    if (args.merge && !hasException(exPtr, exM)) {
+        try {
+            mergeChunks(meshes, N, args, workerCount, writeQ, weldedVerts);
+        } catch (...) {
+            setExceptionOnce(exPtr, exM, std::current_exception());
+        }
+        meshes.clear();
+    }
+
     writeQ.close();
     writer.join();
 
     // rethrow if any thread hit an error
     if (exPtr) std::rethrow_exception(exPtr);
     std::cout << "Exported " << exported.load() << " OBJ files to: " << args.outDir
-              << " using " << workerCount << " worker threads\n";
+              << " using " << workerCount << " worker threads (" << triangles.load() << " triangles";
+    if (args.merge) std::cout << ", " << weldedVerts.load() << " welded vertices";
+    std::cout << ")\n";
     return 0;
 }
 
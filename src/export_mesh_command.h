@@ -1,6 +1,7 @@
 #pragma once
 #include <string>
 #include <cstdint>
+#include <vector>
 
 struct ExportMeshArgs {
     std::string inDir;
@@ -8,6 +9,14 @@ struct ExportMeshArgs {
     uint32_t lodCount = 1;
     float spacing = 1.0f;
     float heightScale = 1.0f;
+    float maxError = -1.0f;    // >= 0: RTIN mesh within this height error (same units as --scale). < 0: full grid
+    bool merge = false;        // one welded mesh (per chunk) instead of one OBJ per tile
+    uint32_t chunks = 1;       // with merge: split the tile grid into chunks x chunks meshes
+
+    // view dependent export. world units = the mesh's x/z (pixels * spacing) and y (--scale)
+    std::vector<float> region;       // x0,z0,x1,z1: only tiles touching this box. empty = every tile
+    std::vector<float> camera;       // x,y,z: tiles are exported nearest first. empty = no camera
+    std::vector<float> lodDistances; // with camera: closer than [0] -> lod0, closer than [1] -> lod1, ... else last+1
 
     bool openBlender = false;
     std::string blenderPath;   // path to blender.exe
@@ -0,0 +1,120 @@
+#include "heightmap_io.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "./third_party/stb_image_write.h"
+#include "./third_party/stb_image.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+/*
+heightmap_io.cpp
+
+Everything that moves heights between disk and memory:
+source heightmap (stb_image), lodN.height.raw tiles, and the u16 <-> u32 conversion
+used for the GPU buffers (one height per uint).
+*/
+
+//helpers
+static bool fileExists(const std::string& path) {
+    return std::filesystem::exists(std::filesystem::path(path));
+}
+
+void loadHeightmap16(const std::string &path, uint32_t &w, uint32_t &h, std::vector<uint16_t> &out)
+{
+    int iw = 0, ih = 0, c = 0;
+    // stbi_load_16 gives 16-bit per channel
+    uint16_t *img = stbi_load_16(path.c_str(), &iw, &ih, &c, 1);
+    if (!img)
+        throw std::runtime_error("Failed to load 16-bit heightmap: " + path);
+
+    w = (uint32_t)iw;
+    h = (uint32_t)ih;
+    out.assign(img, img + (size_t)w * (size_t)h);
+    stbi_image_free(img);
+}
+void writeRawU16(const std::string &path, const std::vector<uint16_t> &data)
+{
+    std::ofstream f(path, std::ios::binary);
+    if (!f)
+        throw std::runtime_error("Failed to write: " + path);
+    f.write(reinterpret_cast<const char *>(data.data()),
+            (std::streamsize)(data.size() * sizeof(uint16_t)));
+}
+std::vector<uint16_t> readRawU16(const std::string& path, size_t count) {
+    std::vector<uint16_t> data(count);
+    std::ifstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("Failed to open: " + path);
+
+    f.read(reinterpret_cast<char*>(data.data()),
+           static_cast<std::streamsize>(count * sizeof(uint16_t)));
+    if (!f) throw std::runtime_error("Failed to read enough bytes: " + path);
+    return data;
+}
+uint32_t rawTileSize(const std::string& path) {
+    std::error_code ec;
+    const uintmax_t bytes = std::filesystem::file_size(path, ec);
+    if (ec || bytes == 0 || bytes % 2 != 0) return 0;
+    uint32_t side = 1;
+    while ((uintmax_t)side * side * 2 < bytes) side++;
+    return (uintmax_t)side * side * 2 == bytes ? side : 0;
+}
+//read count u16s starting at element offset (for borrowing neighbour borders without loading whole tiles)
+static void readRawU16At(std::ifstream& f, const std::string& path, size_t offset, size_t count, uint16_t* out) {
+    f.seekg(static_cast<std::streamoff>(offset * sizeof(uint16_t)));
+    f.read(reinterpret_cast<char*>(out), static_cast<std::streamsize>(count * sizeof(uint16_t)));
+    if (!f) throw std::runtime_error("Failed to read enough bytes: " + path);
+}
+// (N+1) x (N+1) heights: the tile plus column 0 of the east neighbour, row 0 of the south
+// neighbour and (0,0) of the south-east one. Missing neighbours (map edge) repeat the tile's own edge
+void readTileWithBorderU16(const std::string& tilesDir, uint32_t tx, uint32_t ty,
+                           const std::string& heightFile, uint32_t N, std::vector<uint16_t>& g) {
+    const uint32_t G = N + 1;
+    auto tilePath = [&](uint32_t x, uint32_t y) {
+        return tilesDir + "/tile_" + std::to_string(x) + "_" + std::to_string(y) + "/" + heightFile;
+    };
+
+    //read the N x N tile into the front of g, then spread the rows out to stride G (last row first)
+    g.resize(static_cast<size_t>(G) * G);
+    {
+        const std::string self = tilePath(tx, ty);
+        std::ifstream f(self, std::ios::binary);
+        if (!f) throw std::runtime_error("Failed to open: " + self);
+        readRawU16At(f, self, 0, (size_t)N * N, g.data());
+    }
+    for (uint32_t z = N; z-- > 0;) {
+        const auto src = g.begin() + (size_t)z * N;
+        std::copy_backward(src, src + N, g.begin() + (size_t)z * G + N);
+        g[(size_t)z * G + N] = g[(size_t)z * G + N - 1];
+    }
+    for (uint32_t x = 0; x < G; x++) g[(size_t)N * G + x] = g[(size_t)(N - 1) * G + x];
+
+    const std::string east = tilePath(tx + 1, ty);
+    if (fileExists(east)) {
+        std::ifstream f(east, std::ios::binary);
+        for (uint32_t z = 0; z < N; z++) readRawU16At(f, east, (size_t)z * N, 1, &g[(size_t)z * G + N]);
+    }
+    const std::string south = tilePath(tx, ty + 1);
+    if (fileExists(south)) {
+        std::ifstream f(south, std::ios::binary);
+        readRawU16At(f, south, 0, N, &g[(size_t)N * G]);
+        g[(size_t)N * G + N] = g[(size_t)N * G + N - 1];
+    }
+    const std::string southEast = tilePath(tx + 1, ty + 1);
+    if (fileExists(southEast)) {
+        std::ifstream f(southEast, std::ios::binary);
+        readRawU16At(f, southEast, 0, 1, &g[(size_t)N * G + N]);
+    } else if (fileExists(east)) {
+        g[(size_t)N * G + N] = g[(size_t)(N - 1) * G + N];
+    }
+}
+
+void widenU16ToU32(const uint16_t* in, size_t count, uint32_t* out) {
+    for (size_t i = 0; i < count; i++) out[i] = (uint32_t)in[i];
+}
+void narrowU32ToU16(const uint32_t* in, size_t count, uint16_t* out) {
+    for (size_t i = 0; i < count; i++) out[i] = (uint16_t)in[i];
+}
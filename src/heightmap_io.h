@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// source heightmap: any 16-bit (or 8-bit, widened) grayscale image stb_image reads (png, pgm, ...)
+void loadHeightmap16(const std::string& path, uint32_t& w, uint32_t& h, std::vector<uint16_t>& out);
+
+// lodN.height.raw files: row major u16, no header
+void writeRawU16(const std::string& path, const std::vector<uint16_t>& data);
+std::vector<uint16_t> readRawU16(const std::string& path, size_t count);
+// side length of a square lodN.height.raw (build --tile-size >> N). 0 if missing or not square
+uint32_t rawTileSize(const std::string& path);
+
+// (N+1) x (N+1) heights: tile (tx,ty) of tilesDir plus the first column/row of its east/south
+// neighbours (heightFile picks the LOD, e.g. "lod0.height.raw"). Map edges repeat the tile's own edge.
+// out is resized (not reallocated once it has the capacity) so export can reuse pooled buffers
+void readTileWithBorderU16(const std::string& tilesDir, uint32_t tx, uint32_t ty,
+                           const std::string& heightFile, uint32_t N, std::vector<uint16_t>& out);
+
+// GPU buffers store one height per uint
+void widenU16ToU32(const uint16_t* in, size_t count, uint32_t* out);
+void narrowU32ToU16(const uint32_t* in, size_t count, uint16_t* out);
@@ -0,0 +1,141 @@
+#include "kernel_profile.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+/*
+kernel_profile.cpp
+
+1) makeKernelSpec: TILE_SIZE + workgroup shape + rows as specialization constants 0..3
+   kernelConfigFits: shape vs the device's workgroup limits (autotune candidates, build's loaded profile)
+2) deviceUUIDString: the Vulkan 1.1 device UUID (stable across driver updates, unlike pipelineCacheUUID)
+3) load/save: plain text blocks keyed by that UUID + tile size, see kernel_profile.h
+*/
+
+void makeKernelSpec(uint32_t tileSize, const KernelConfig& cfg, KernelSpec& out) {
+    out.values[0] = tileSize;
+    out.values[1] = cfg.localX;
+    out.values[2] = cfg.localY;
+    out.values[3] = cfg.rows;
+    for (uint32_t i = 0; i < 4; i++) {
+        out.entries[i] = VkSpecializationMapEntry{ i, i * (uint32_t)sizeof(uint32_t), sizeof(uint32_t) };
+    }
+    // ids a shader doesn't declare (downsample has no TILE_SIZE) are ignored by Vulkan
+    out.info = VkSpecializationInfo{ 4, out.entries, sizeof(out.values), out.values };
+}
+
+bool kernelConfigFits(const KernelConfig& cfg, const VkPhysicalDeviceLimits& limits) {
+    return cfg.localX <= limits.maxComputeWorkGroupSize[0] && cfg.localY <= limits.maxComputeWorkGroupSize[1]
+        && (uint64_t)cfg.localX * cfg.localY <= limits.maxComputeWorkGroupInvocations;
+}
+
+uint32_t kernelGroupsX(const KernelConfig& cfg, uint32_t size) {
+    return (size + cfg.localX - 1) / cfg.localX;
+}
+uint32_t kernelGroupsY(const KernelConfig& cfg, uint32_t size) {
+    const uint32_t perGroup = cfg.localY * cfg.rows;
+    return (size + perGroup - 1) / perGroup;
+}
+
+std::string deviceUUIDString(VkPhysicalDevice physicalDevice) {
+    VkPhysicalDeviceIDProperties idProps{};
+    idProps.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+    VkPhysicalDeviceProperties2 props2{};
+    props2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    props2.pNext = &idProps;
+    vkGetPhysicalDeviceProperties2(physicalDevice, &props2);
+
+    std::string out;
+    char hex[3];
+    for (uint32_t i = 0; i < VK_UUID_SIZE; i++) {
+        std::snprintf(hex, sizeof(hex), "%02x", idProps.deviceUUID[i]);
+        out += hex;
+    }
+    return out;
+}
+
+//helpers
+static bool readConfig(std::istringstream& line, KernelConfig& cfg) {
+    KernelConfig c;
+    if (!(line >> c.localX >> c.localY >> c.rows)) return false;
+    if (c.localX == 0 || c.localY == 0 || c.rows == 0) return false;
+    cfg = c;
+    return true;
+}
+
+static void writeBlock(std::ostream& f, const KernelProfile& p) {
+    auto cfgLine = [&](const char* name, const KernelConfig& c) {
+        f << name << " " << c.localX << " " << c.localY << " " << c.rows << "\n";
+    };
+    f << "device " << p.deviceUUID << " " << p.deviceName << "\n";
+    f << "tile_size " << p.tileSize << "\n";
+    cfgLine("extract", p.extract);
+    cfgLine("downsample", p.downsample);
+    cfgLine("normals", p.normals);
+    cfgLine("splat", p.splat);
+}
+
+// every block in the file, in order
+static std::vector<KernelProfile> readProfiles(const std::string& path) {
+    std::vector<KernelProfile> out;
+    std::ifstream f(path);
+    if (!f) return out;
+
+    std::string text;
+    while (std::getline(f, text)) {
+        std::istringstream line(text);
+        std::string key;
+        if (!(line >> key) || key[0] == '#') continue;
+
+        if (key == "device") {
+            KernelProfile p;
+            line >> p.deviceUUID;
+            std::getline(line >> std::ws, p.deviceName);
+            out.push_back(p);
+            continue;
+        }
+        if (out.empty()) throw std::runtime_error("Corrupt autotune profile (kernel before device): " + path);
+
+        KernelProfile& p = out.back();
+        bool ok = true;
+        if (key == "tile_size") ok = static_cast<bool>(line >> p.tileSize);
+        else if (key == "extract") ok = readConfig(line, p.extract);
+        else if (key == "downsample") ok = readConfig(line, p.downsample);
+        else if (key == "normals") ok = readConfig(line, p.normals);
+        else if (key == "splat") ok = readConfig(line, p.splat);
+        // unknown kernels are skipped so older builds can read newer files
+        if (!ok) throw std::runtime_error("Corrupt autotune profile line '" + text + "': " + path);
+    }
+    return out;
+}
+
+bool loadKernelProfile(const std::string& path, const std::string& deviceUUID, uint32_t tileSize, KernelProfile& out) {
+    for (const KernelProfile& p : readProfiles(path)) {
+        if (p.deviceUUID == deviceUUID && p.tileSize == tileSize) {
+            out = p;
+            return true;
+        }
+    }
+    return false;
+}
+
+void saveKernelProfile(const std::string& path, const KernelProfile& profile) {
+    std::vector<KernelProfile> all = readProfiles(path);
+    bool replaced = false;
+    for (KernelProfile& p : all) {
+        if (p.deviceUUID == profile.deviceUUID && p.tileSize == profile.tileSize) {
+            p = profile;
+            replaced = true;
+        }
+    }
+    if (!replaced) all.push_back(profile);
+
+    std::ofstream f(path);
+    if (!f) throw std::runtime_error("Failed to write: " + path);
+    f << "# auroraterrian autotune profiles. written by `autotune`, read by `build`\n";
+    for (const KernelProfile& p : all) writeBlock(f, p);
+    if (!f) throw std::runtime_error("Failed to write: " + path);
+}
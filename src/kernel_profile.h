@@ -0,0 +1,66 @@
+#pragma once
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+
+/*
+kernel_profile.h
+
+Workgroup shape + pixels per thread for the per pixel kernels (extract_tile, downsample, normals, splat).
+They are specialization constants in the shaders, so one .spv runs any shape:
+  constant_id 0 = TILE_SIZE, 1 = local size x, 2 = local size y, 3 = ROWS (pixels per thread, down y)
+
+`autotune` times a set of shapes on the current GPU and saves the fastest per device UUID and
+tile size (the best shape for 256 tiles isn't the best for 1024). `build` loads the profile for its
+device and --tile-size on its own and falls back to 16x16, 1 row when there is none, or for any entry
+the device can't run (hand edited file, different driver limits).
+
+Profile file (text, one block per device and tile size, written by saveKernelProfile):
+  device <uuid hex> <device name>
+  tile_size <n>
+  extract <x> <y> <rows>
+  downsample <x> <y> <rows>
+  normals <x> <y> <rows>
+  splat <x> <y> <rows>         (missing in older files = 16x16, 1 row)
+*/
+
+static constexpr const char* DEFAULT_PROFILE_PATH = "autotune.profile"; // next to the exe, like ../shaders
+
+struct KernelConfig {
+    uint32_t localX = 16;
+    uint32_t localY = 16;
+    uint32_t rows = 1; // pixels per thread. a workgroup covers localX x (localY * rows)
+};
+
+struct KernelProfile {
+    std::string deviceUUID;
+    std::string deviceName;
+    uint32_t tileSize = 0; // what autotune measured with. 0 = not recorded (older files), never matches
+    KernelConfig extract;
+    KernelConfig downsample;
+    KernelConfig normals;
+    KernelConfig splat; // reads 5 step x step blocks per pixel, so its own entry rather than normals'
+};
+
+// specialization data for one pipeline. keep it alive until the pipeline is created
+struct KernelSpec {
+    uint32_t values[4]{};
+    VkSpecializationMapEntry entries[4]{};
+    VkSpecializationInfo info{};
+};
+void makeKernelSpec(uint32_t tileSize, const KernelConfig& cfg, KernelSpec& out);
+
+// within maxComputeWorkGroupSize / maxComputeWorkGroupInvocations
+bool kernelConfigFits(const KernelConfig& cfg, const VkPhysicalDeviceLimits& limits);
+
+// workgroups needed to cover size x size pixels
+uint32_t kernelGroupsX(const KernelConfig& cfg, uint32_t size);
+uint32_t kernelGroupsY(const KernelConfig& cfg, uint32_t size);
+
+// VkPhysicalDeviceIDProperties::deviceUUID as 32 hex chars
+std::string deviceUUIDString(VkPhysicalDevice physicalDevice);
+
+// false if the file is missing or has nothing for this device and tile size
+bool loadKernelProfile(const std::string& path, const std::string& deviceUUID, uint32_t tileSize, KernelProfile& out);
+// adds or replaces the block for this device and tile size, other blocks in the file are kept
+void saveKernelProfile(const std::string& path, const KernelProfile& profile);
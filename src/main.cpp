@@ -1,6 +1,8 @@
+#include "autotune_command.h"
 #include "build_command.h"
 #include "vk_util.h"
 #include "export_mesh_command.h"
+#include "trace.h"
 
 #include <vulkan/vulkan.h>
 #include <iostream>
@@ -8,6 +10,19 @@
 #include <vector>
 
 
+// "1,2.5,3" -> {1, 2.5, 3}
+static std::vector<float> parseFloatList(const std::string& s) {
+    std::vector<float> out;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t comma = s.find(',', start);
+        if (comma == std::string::npos) comma = s.size();
+        out.push_back(std::stof(s.substr(start, comma - start)));
+        start = comma + 1;
+    }
+    return out;
+}
+
 //for args for building
 static BuildArgs parseBuildArgs(int argc, char** argv) {
     BuildArgs a;
@@ -19,7 +34,27 @@ static BuildArgs parseBuildArgs(int argc, char** argv) {
         if (s == "--heightmap" && i + 1 < argc) a.heightmapPath = argv[++i];
         else if (s == "--out" && i + 1 < argc) a.outDir = argv[++i];
         else if (s == "--lods" && i + 1 < argc) a.lodCount = (uint32_t)std::stoul(argv[++i]);
-        // tileSize fixed to 256 per your request
+        else if (s == "--bake-normals") a.bakeNormals = true;
+        else if (s == "--normal-strength" && i + 1 < argc) a.normalStrength = std::stof(argv[++i]);
+        else if (s == "--splat" && i + 1 < argc) a.splatRulesPath = argv[++i];
+        else if (s == "--tile-size" && i + 1 < argc) a.tileSize = (uint32_t)std::stoul(argv[++i]);
+        else if (s == "--profile" && i + 1 < argc) a.profilePath = argv[++i];
+        else if (s == "--filter" && i + 1 < argc) a.filters = parseFilterSteps(argv[++i]);
+        else if (s == "--talus" && i + 1 < argc) a.filterParams.talus = std::stof(argv[++i]);
+        else if (s == "--rain" && i + 1 < argc) a.filterParams.rain = std::stof(argv[++i]);
+    }
+    return a;
+}
+
+//for args for autotune
+static AutotuneArgs parseAutotuneArgs(int argc, char** argv) {
+    AutotuneArgs a;
+
+    for (int i = 2; i < argc; i++) {
+        std::string s = argv[i];
+        if (s == "--profile" && i + 1 < argc) a.profilePath = argv[++i];
+        else if (s == "--tile-size" && i + 1 < argc) a.tileSize = (uint32_t)std::stoul(argv[++i]);
+        else if (s == "--iters" && i + 1 < argc) a.iters = (uint32_t)std::stoul(argv[++i]);
     }
     return a;
 }
@@ -38,6 +73,12 @@ ExportMeshArgs a;
         else if (s == "--lods" && i + 1 < argc) a.lodCount = (uint32_t)std::stoul(argv[++i]);
         else if (s == "--scale" && i + 1 < argc) a.heightScale = std::stof(argv[++i]);
         else if (s == "--spacing" && i + 1 < argc) a.spacing = std::stof(argv[++i]);
+        else if (s == "--max-error" && i + 1 < argc) a.maxError = std::stof(argv[++i]);
+        else if (s == "--merge") a.merge = true;
+        else if (s == "--chunks" && i + 1 < argc) a.chunks = (uint32_t)std::stoul(argv[++i]);
+        else if (s == "--region" && i + 1 < argc) a.region = parseFloatList(argv[++i]);
+        else if (s == "--camera" && i + 1 < argc) a.camera = parseFloatList(argv[++i]);
+        else if (s == "--lod-distances" && i + 1 < argc) a.lodDistances = parseFloatList(argv[++i]);
     }
     return a;
 }
@@ -48,18 +89,34 @@ int main(int argc, char** argv) {
     //set args to find with cmd
     if (argc < 2) {
         std::cout << "Usage:\n"
-          << "  auroraterrian.exe build --heightmap path --out out/world --lods 5\n"
-          << "  auroraterrian.exe export_mesh --in out/world --out out/meshes --lods 5 --scale 100 --spacing 1\n";
+          << "  auroraterrian.exe build --heightmap path --out out/world --lods 5 [--tile-size 256] [--bake-normals] [--normal-strength 100] [--splat rules.json]\n"
+          << "      [--filter smooth:2,thermal:50,hydraulic:100 [--talus 0.004] [--rain 0.0005]]\n"
+          << "      [--profile autotune.profile] [--trace build.json]\n"
+          << "  auroraterrian.exe autotune [--tile-size 256] [--iters 10] [--profile autotune.profile]\n"
+          << "  auroraterrian.exe export_mesh --in out/world --out out/meshes --lods 5 --scale 100 --spacing 1 [--max-error 0.5] [--merge [--chunks 2]]\n"
+          << "      [--region x0,z0,x1,z1] [--camera x,y,z [--lod-distances 500,1000,2000]] [--trace export.json]\n";
 
         return 0;
     }
 
     std::string cmd = argv[1];
 
+    // --trace out.json works for every command
+    std::string tracePath;
+    for (int i = 2; i + 1 < argc; i++) {
+        if (std::string(argv[i]) == "--trace") tracePath = argv[i + 1];
+    }
+    if (!tracePath.empty()) traceStart(tracePath);
+    struct TraceFlush {
+        ~TraceFlush() {
+            try { traceStop(); } catch (const std::exception& e) { std::cerr << "trace error: " << e.what() << "\n"; }
+        }
+    } traceFlush;
+
 // export arg
 if (cmd == "export_mesh") {
-    ExportMeshArgs args = parseExportArgs(argc, argv);
     try {
+        ExportMeshArgs args = parseExportArgs(argc, argv); // --region/--camera/--lod-distances can be malformed
         return runExportMeshCommand(args);
     } catch (const std::exception& e) {
         std::cerr << "export_mesh error: " << e.what() << "\n";
@@ -68,82 +125,18 @@ if (cmd == "export_mesh") {
 }
 
 
-    // --- 1) Vulkan init ---
-    VkApplicationInfo app{VK_STRUCTURE_TYPE_APPLICATION_INFO};
-    app.pApplicationName = "AuroraTerrain";
-    app.apiVersion = VK_API_VERSION_1_2;
-   
-    // Validation layer (just to help)
-    std::vector<const char*> enabledLayers;
-    {
-        uint32_t layerCount = 0;
-        vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
-        std::vector<VkLayerProperties> layers(layerCount);
-        vkEnumerateInstanceLayerProperties(&layerCount, layers.data());
-
-        const char* kValidation = "VK_LAYER_KHRONOS_validation";
-        if (hasLayer(layers, kValidation)) {
-            enabledLayers.push_back(kValidation);
-        } else {
-            std::cerr << "[Warn] Validation layer not found (ok, but debugging is harder).\n";
-        }
-    }
-
-    VkInstanceCreateInfo instInfo{VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
-    instInfo.pApplicationInfo = &app;
-    instInfo.enabledLayerCount = static_cast<uint32_t>(enabledLayers.size());
-    instInfo.ppEnabledLayerNames = enabledLayers.empty() ? nullptr : enabledLayers.data();
-
-    VkInstance instance = VK_NULL_HANDLE;
-    vkCheck(vkCreateInstance(&instInfo, nullptr, &instance), "vkCreateInstance");
-
-
-    // --- 2) find devices (and its info like queue) ---
-    uint32_t devCount = 0;
-    vkCheck(vkEnumeratePhysicalDevices(instance, &devCount, nullptr), "vkEnumeratePhysicalDevices(count)");
-    if (devCount == 0) {
-        std::cerr << "No Vulkan physical devices found.\n";
+    // --- Vulkan init (instance, device, compute queue) ---
+    VulkanContext ctx;
+    try {
+        ctx = createVulkanContext(true);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
         return 1;
     }
-    std::vector<VkPhysicalDevice> devs(devCount);
-    vkCheck(vkEnumeratePhysicalDevices(instance, &devCount, devs.data()), "vkEnumeratePhysicalDevices(list)");
-
-    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
-    uint32_t computeQueueFamily = UINT32_MAX;
-
-    for (auto d : devs) {
-        uint32_t qCount = 0;
-        vkGetPhysicalDeviceQueueFamilyProperties(d, &qCount, nullptr);
-        std::vector<VkQueueFamilyProperties> qProps(qCount);
-        vkGetPhysicalDeviceQueueFamilyProperties(d, &qCount, qProps.data());
-
-        for (uint32_t i = 0; i < qCount; i++) {
-            if (qProps[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
-                physicalDevice = d;
-                computeQueueFamily = i;
-                break;
-            }
-        }
-        if (physicalDevice) break;
-    }
-
-    if (!physicalDevice) { std::cerr << "No compute-capable GPU found.\n"; return 1; }
-
-    float prio = 1.0f;
-    VkDeviceQueueCreateInfo qInfo{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
-    qInfo.queueFamilyIndex = computeQueueFamily;
-    qInfo.queueCount = 1;
-    qInfo.pQueuePriorities = &prio;
-
-    VkDeviceCreateInfo devInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
-    devInfo.queueCreateInfoCount = 1;
-    devInfo.pQueueCreateInfos = &qInfo;
-
-    VkDevice device = VK_NULL_HANDLE;
-    vkCheck(vkCreateDevice(physicalDevice, &devInfo, nullptr, &device), "vkCreateDevice");
-
-    VkQueue queue = VK_NULL_HANDLE;
-    vkGetDeviceQueue(device, computeQueueFamily, 0, &queue);
+    VkDevice device = ctx.device;
+    VkPhysicalDevice physicalDevice = ctx.physicalDevice;
+    VkQueue queue = ctx.queue;
+    uint32_t computeQueueFamily = ctx.computeQueueFamily;
 
     int rc = 0;
 
@@ -156,15 +149,27 @@ if (cmd == "export_mesh") {
 
 
     if (cmd == "build") {
-        BuildArgs args = parseBuildArgs(argc, argv);
-        rc = runBuildCommand(device, physicalDevice, queue, computeQueueFamily, args);
+        try {
+            BuildArgs args = parseBuildArgs(argc, argv); // --filter lists can be malformed
+            rc = runBuildCommand(device, physicalDevice, queue, computeQueueFamily, args);
+        } catch (const std::exception& e) {
+            std::cerr << "build error: " << e.what() << "\n";
+            rc = 1;
+        }
+    } else if (cmd == "autotune") {
+        try {
+            AutotuneArgs args = parseAutotuneArgs(argc, argv);
+            rc = runAutotuneCommand(device, physicalDevice, queue, computeQueueFamily, args);
+        } catch (const std::exception& e) {
+            std::cerr << "autotune error: " << e.what() << "\n";
+            rc = 1;
+        }
     }   else {
         std::cerr << "Unknown command: " << cmd << "\n";
-        return 1;
+        rc = 1;
     }
 
     
-    vkDestroyDevice(device, nullptr);
-    vkDestroyInstance(instance, nullptr);
+    destroyVulkanContext(ctx);
     return rc;
 }
@@ -0,0 +1,162 @@
+#include "mesh_merge.h"
+
+#include <atomic>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+/*
+mesh_merge.cpp
+
+1) per tile (parallel): which vertices it owns (ownerOf), their rank among owned, and the vertex
+   index of its x == 0 / z == 0 border points, so neighbours can look them up
+2) prefix sums (serial): where every tile's owned vertices and indices start in the output
+3) per tile (parallel): copy owned vertices, rewrite indices into the global index space
+*/
+
+static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+
+namespace {
+struct TileInfo {
+    const TileMesh* mesh = nullptr;
+    int next[2][3] = { { -1, -1, -1 }, { -1, -1, -1 } }; // tile slot at (x + dx, y + dy), [dx][dy + 1]. -1 = none
+    std::vector<uint32_t> westCol;  // local vertex at (0, z)
+    std::vector<uint32_t> northRow; // local vertex at (x, 0)
+    std::vector<uint32_t> ownedRank; // per vertex: rank among owned, NOT_FOUND if a neighbour owns it
+    size_t vertOffset = 0;
+    size_t idxOffset = 0;
+};
+}
+
+// run fn(i) for i in [0, count) on threadCount threads. first exception wins
+template <typename Fn>
+static void parallelFor(size_t count, uint32_t threadCount, Fn fn) {
+    std::atomic<size_t> next{0};
+    std::exception_ptr exPtr = nullptr;
+    std::mutex exM;
+    auto body = [&] {
+        try {
+            for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) fn(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lk(exM);
+            if (!exPtr) exPtr = std::current_exception();
+            next.store(count);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (uint32_t t = 1; t < threadCount; t++) threads.emplace_back(body);
+    body();
+    for (auto& th : threads) th.join();
+    if (exPtr) std::rethrow_exception(exPtr);
+}
+
+void mergeTileMeshes(const std::vector<const TileMesh*>& tiles, uint32_t N, uint32_t threadCount,
+                     std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx)
+{
+    const uint32_t G = N + 1;
+    if (threadCount == 0) threadCount = 1;
+
+    std::vector<TileInfo> info(tiles.size());
+    std::map<std::pair<uint32_t, uint32_t>, int> slot;
+    for (size_t i = 0; i < tiles.size(); i++) {
+        info[i].mesh = tiles[i];
+        slot[{ tiles[i]->tileX, tiles[i]->tileY }] = (int)i;
+    }
+    for (size_t i = 0; i < info.size(); i++) {
+        TileInfo& t = info[i];
+        for (uint32_t dx = 0; dx < 2; dx++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                if (dy < 0 && t.mesh->tileY == 0) continue;
+                auto it = slot.find({ t.mesh->tileX + dx, t.mesh->tileY + dy });
+                if (it != slot.end()) t.next[dx][dy + 1] = it->second;
+            }
+        }
+    }
+
+    // tile owning grid point (x, z) of tile ti, and the point in its grid. Candidates are ti and, on its
+    // east/south border, the tiles east / north east / south / south east. Furthest east then south wins
+    auto ownerOf = [&](int ti, uint32_t x, uint32_t z, uint32_t& ox, uint32_t& oz) -> int {
+        const TileInfo& t = info[(size_t)ti];
+        int best = ti;
+        ox = x;
+        oz = z;
+        for (uint32_t dx = 0; dx < 2; dx++) {
+            if (dx == 1 && x != N) break;
+            for (int dy = -1; dy <= 1; dy++) {
+                if ((dy < 0 && z != 0) || (dy > 0 && z != N)) continue;
+                const int c = t.next[dx][dy + 1];
+                if (c < 0) continue;
+                best = c; // later candidates are further east/south
+                ox = x - dx * N;
+                oz = (uint32_t)((int)z - dy * (int)N);
+            }
+        }
+        return best;
+    };
+
+    // --- 1) ownership + border lookup tables ---
+    parallelFor(info.size(), threadCount, [&](size_t i) {
+        TileInfo& t = info[i];
+        const auto& vg = t.mesh->vertGrid;
+        t.westCol.assign(G, NOT_FOUND);
+        t.northRow.assign(G, NOT_FOUND);
+        t.ownedRank.assign(vg.size(), NOT_FOUND);
+
+        uint32_t owned = 0;
+        for (size_t v = 0; v < vg.size(); v++) {
+            const uint32_t x = vg[v] % G;
+            const uint32_t z = vg[v] / G;
+            if (x == 0) t.westCol[z] = (uint32_t)v;
+            if (z == 0) t.northRow[x] = (uint32_t)v;
+
+            uint32_t ox = 0, oz = 0;
+            if (ownerOf((int)i, x, z, ox, oz) == (int)i) t.ownedRank[v] = owned++;
+        }
+        t.vertOffset = owned; // count for now, offset after step 2
+    });
+
+    // --- 2) prefix sums ---
+    size_t vertTotal = 0, idxTotal = 0;
+    for (auto& t : info) {
+        const size_t owned = t.vertOffset;
+        t.vertOffset = vertTotal;
+        t.idxOffset = idxTotal;
+        vertTotal += owned;
+        idxTotal += t.mesh->idx.size();
+    }
+    outVertsXYZ.resize(vertTotal * 3);
+    outIdx.resize(idxTotal);
+
+    // output vertex of grid point (x, z) of tile ti. The owner has it on its west column or north row
+    auto resolve = [&](int ti, uint32_t x, uint32_t z) -> size_t {
+        uint32_t ox = 0, oz = 0;
+        const TileInfo& owner = info[(size_t)ownerOf(ti, x, z, ox, oz)];
+        const uint32_t v = (ox == 0) ? owner.westCol[oz] : (oz == 0) ? owner.northRow[ox] : NOT_FOUND;
+        if (v == NOT_FOUND || owner.ownedRank[v] == NOT_FOUND)
+            throw std::runtime_error("Tile mesh is missing a border vertex; cannot weld.");
+        return owner.vertOffset + owner.ownedRank[v];
+    };
+
+    // --- 3) copy + remap ---
+    parallelFor(info.size(), threadCount, [&](size_t i) {
+        const TileInfo& t = info[i];
+        const TileMesh& m = *t.mesh;
+
+        std::vector<uint32_t> toGlobal(m.vertGrid.size());
+        for (size_t v = 0; v < m.vertGrid.size(); v++) {
+            if (t.ownedRank[v] != NOT_FOUND) {
+                const size_t g = t.vertOffset + t.ownedRank[v];
+                outVertsXYZ[g * 3 + 0] = m.verts[v * 3 + 0];
+                outVertsXYZ[g * 3 + 1] = m.verts[v * 3 + 1];
+                outVertsXYZ[g * 3 + 2] = m.verts[v * 3 + 2];
+                toGlobal[v] = (uint32_t)g;
+            } else {
+                toGlobal[v] = (uint32_t)resolve((int)i, m.vertGrid[v] % G, m.vertGrid[v] / G);
+            }
+        }
+        for (size_t k = 0; k < m.idx.size(); k++) outIdx[t.idxOffset + k] = toGlobal[m.idx[k]];
+    });
+}
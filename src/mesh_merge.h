@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/*
+mesh_merge.h
+
+Weld per-tile meshes into one mesh with a single index space.
+
+Every tile mesh covers (N+1) x (N+1) grid points: its own N x N heights plus the first
+column/row of the east/south neighbour. So the last column of a tile and the first column of
+its east neighbour are the same points. Those are written once and everybody else points at
+them. The owner is the tile furthest east, then furthest south, that has the point, so a
+corner shared by up to 4 tiles has one owner whichever of them are missing.
+
+Tile meshes must contain every border vertex (full grid, or RTIN with locked borders).
+*/
+
+struct TileMesh {
+    uint32_t tileX = 0;
+    uint32_t tileY = 0;
+    std::vector<float> verts;       // xyz, world space
+    std::vector<uint32_t> idx;      // 3 per triangle, local to this tile
+    std::vector<uint32_t> vertGrid; // per vertex: z * (N+1) + x inside the (N+1)^2 tile grid
+};
+
+// tiles may be in any order and have holes. threadCount threads do the per tile work
+void mergeTileMeshes(const std::vector<const TileMesh*>& tiles, uint32_t N, uint32_t threadCount,
+                     std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx);
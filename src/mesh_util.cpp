@@ -0,0 +1,163 @@
+#include "mesh_util.h"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+
+//regular grid mesh, one vertex per height
+//FixedN = 0: grid size only known at run time. Otherwise N is a compile time constant, so the loops
+//get fixed trip counts the compiler can unroll/vectorize
+template <uint32_t FixedN>
+static void buildGridMesh(const std::vector<uint16_t>& h, uint32_t runtimeN, float spacing,
+                          float heightScale, float baseX, float baseZ,
+                          std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx)
+{
+    const uint32_t N = FixedN ? FixedN : runtimeN;
+    outVertsXYZ.clear();
+    outVertsXYZ.resize(static_cast<size_t>(N) * N * 3);
+
+    //for all Vertices in x in z
+    for (uint32_t z = 0; z < N; z++) {
+        for (uint32_t x = 0; x < N; x++) {
+            const uint32_t i = z * N + x;
+
+            float px = float(x) * spacing + baseX; //horizontal plane
+            float pz = float(z) * spacing + baseZ;
+
+            float yn = float(h[i]) / 65535.0f;   //Vertical plane. (Height is Normalized since in a heightmap, height = intensity)
+            float py = yn * heightScale;
+
+            const size_t vi = (size_t)i * 3; //store the data in the array
+            outVertsXYZ[vi + 0] = px;
+            outVertsXYZ[vi + 1] = py;
+            outVertsXYZ[vi + 2] = pz;
+        }
+    }
+
+    outIdx.clear();
+    outIdx.resize(static_cast<size_t>(N - 1) * (N - 1) * 6);//2 triangles each quad. 6 points
+    uint32_t* idx = outIdx.data();
+
+    //for all Vertices in x in z
+    for (uint32_t z = 0; z < N - 1; z++) {
+        for (uint32_t x = 0; x < N - 1; x++) {
+            uint32_t i0 = z * N + x;        //top left triangle
+            uint32_t i1 = z * N + (x + 1);  //top right triangle
+            uint32_t i2 = (z + 1) * N + x;  //bottom left triangle
+            uint32_t i3 = (z + 1) * N + (x + 1);//bottom right triangle
+
+            idx[0] = i0; idx[1] = i2; idx[2] = i1;
+            idx[3] = i1; idx[4] = i2; idx[5] = i3;
+            idx += 6;
+        }
+    }
+}
+
+void buildGridMeshFromHeightU16(const std::vector<uint16_t>& h, uint32_t N, float spacing,
+                                float heightScale, float baseX, float baseZ,
+                                std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx)
+{
+    //build --tile-size 64..1024 and their LODs, + the border row/column
+    switch (N) {
+    case 1025: buildGridMesh<1025>(h, N, spacing, heightScale, baseX, baseZ, outVertsXYZ, outIdx); break;
+    case 513:  buildGridMesh<513>(h, N, spacing, heightScale, baseX, baseZ, outVertsXYZ, outIdx); break;
+    case 257:  buildGridMesh<257>(h, N, spacing, heightScale, baseX, baseZ, outVertsXYZ, outIdx); break;
+    case 129:  buildGridMesh<129>(h, N, spacing, heightScale, baseX, baseZ, outVertsXYZ, outIdx); break;
+    case 65:   buildGridMesh<65>(h, N, spacing, heightScale, baseX, baseZ, outVertsXYZ, outIdx); break;
+    case 33:   buildGridMesh<33>(h, N, spacing, heightScale, baseX, baseZ, outVertsXYZ, outIdx); break;
+    default:   buildGridMesh<0>(h, N, spacing, heightScale, baseX, baseZ, outVertsXYZ, outIdx); break;
+    }
+}
+
+void trimTileMesh(uint32_t G, uint32_t lastX, uint32_t lastZ, float spacing, float baseX, float baseZ,
+                  std::vector<float>& vertsXYZ, std::vector<uint32_t>& idx, std::vector<uint32_t>& vertGrid)
+{
+    if (lastX + 1 >= G && lastZ + 1 >= G) return; //nothing past the map
+
+    //clamp + compact in place (a vertex only ever moves down). first vertex at a grid point wins
+    std::unordered_map<uint32_t, uint32_t> kept;
+    std::vector<uint32_t> remap(vertGrid.size());
+    uint32_t count = 0;
+    for (size_t v = 0; v < vertGrid.size(); v++) {
+        const uint32_t x = std::min(vertGrid[v] % G, lastX);
+        const uint32_t z = std::min(vertGrid[v] / G, lastZ);
+        const auto [it, added] = kept.emplace(z * G + x, count);
+        if (added) {
+            vertsXYZ[(size_t)count * 3 + 0] = float(x) * spacing + baseX;
+            vertsXYZ[(size_t)count * 3 + 1] = vertsXYZ[v * 3 + 1];
+            vertsXYZ[(size_t)count * 3 + 2] = float(z) * spacing + baseZ;
+            vertGrid[count] = z * G + x;
+            count++;
+        }
+        remap[v] = it->second;
+    }
+    vertsXYZ.resize((size_t)count * 3);
+    vertGrid.resize(count);
+
+    //triangles with no area seen from above were entirely in the padding (or are now a line along the edge)
+    size_t out = 0;
+    for (size_t t = 0; t + 2 < idx.size(); t += 3) {
+        const uint32_t a = remap[idx[t]], b = remap[idx[t + 1]], c = remap[idx[t + 2]];
+        const int64_t ax = vertGrid[a] % G, az = vertGrid[a] / G;
+        const int64_t bx = vertGrid[b] % G, bz = vertGrid[b] / G;
+        const int64_t cx = vertGrid[c] % G, cz = vertGrid[c] / G;
+        if ((bx - ax) * (cz - az) - (cx - ax) * (bz - az) == 0) continue;
+        idx[out++] = a;
+        idx[out++] = b;
+        idx[out++] = c;
+    }
+    idx.resize(out);
+}
+
+void addTileSkirts(uint32_t G, uint32_t edgeMask, float depth,
+                   std::vector<float>& vertsXYZ, std::vector<uint32_t>& idx, const std::vector<uint32_t>& vertGrid)
+{
+    struct EdgeDef { TileEdge edge; bool alongX; uint32_t line; bool flip; }; //flip: winding so the strip faces out
+    const EdgeDef defs[4] = {
+        { EDGE_WEST, false, 0, true }, { EDGE_EAST, false, G - 1, false },
+        { EDGE_NORTH, true, 0, false }, { EDGE_SOUTH, true, G - 1, true },
+    };
+    std::vector<std::pair<uint32_t, uint32_t>> edge; //(position along the edge, vertex)
+    for (const EdgeDef& d : defs) {
+        if (!(edgeMask & d.edge)) continue;
+
+        edge.clear();
+        for (size_t v = 0; v < vertGrid.size(); v++) {
+            const uint32_t x = vertGrid[v] % G, z = vertGrid[v] / G;
+            if ((d.alongX ? z : x) == d.line) edge.push_back({ d.alongX ? x : z, (uint32_t)v });
+        }
+        std::sort(edge.begin(), edge.end());
+
+        //every edge vertex gets a copy depth lower, then a quad (2 triangles) per edge segment
+        const uint32_t first = (uint32_t)(vertsXYZ.size() / 3);
+        for (const auto& e : edge) {
+            const size_t v = (size_t)e.second * 3;
+            const float x = vertsXYZ[v + 0], y = vertsXYZ[v + 1], z = vertsXYZ[v + 2];
+            vertsXYZ.insert(vertsXYZ.end(), { x, y - depth, z });
+        }
+        for (size_t k = 0; k + 1 < edge.size(); k++) {
+            const uint32_t a = edge[k].second, b = edge[k + 1].second;
+            const uint32_t la = first + (uint32_t)k, lb = la + 1;
+            if (d.flip) {
+                idx.insert(idx.end(), { a, la, b, b, la, lb });
+            } else {
+                idx.insert(idx.end(), { a, b, la, b, lb, la });
+            }
+        }
+    }
+}
+
+//helper to write OBJ files
+void writeOBJ(const std::string& path, const std::vector<float>& vertsXYZ, const std::vector<uint32_t>& indices)
+{
+    std::ofstream o(path);
+    if (!o) throw std::runtime_error("Failed to write: " + path);
+
+    for (size_t i = 0; i < vertsXYZ.size(); i += 3) {
+        o << "v " << vertsXYZ[i] << " " << vertsXYZ[i + 1] << " " << vertsXYZ[i + 2] << "\n";
+    }
+    for (size_t i = 0; i < indices.size(); i += 3) {
+        o << "f " << (indices[i] + 1) << " " << (indices[i + 1] + 1) << " " << (indices[i + 2] + 1) << "\n";
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// h is N x N heights, N = tile size + 1 (see readTileWithBorderU16). baseX/baseZ = tile corner in world.
+// 2 triangles per quad, y = h / 65535 * heightScale
+void buildGridMeshFromHeightU16(const std::vector<uint16_t>& h, uint32_t N, float spacing,
+                                float heightScale, float baseX, float baseZ,
+                                std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx);
+
+// edge tiles of a map that isn't a multiple of the tile size: pull every vertex past grid column lastX /
+// row lastZ of a G x G tile mesh back onto it (the padding there repeats that column/row, so heights
+// already match), drop the triangles that collapse and merge the doubled vertices.
+// vertGrid = z * G + x of every vertex, kept in step. Same placement as buildGridMeshFromHeightU16
+void trimTileMesh(uint32_t G, uint32_t lastX, uint32_t lastZ, float spacing, float baseX, float baseZ,
+                  std::vector<float>& vertsXYZ, std::vector<uint32_t>& idx, std::vector<uint32_t>& vertGrid);
+
+// tile edges for addTileSkirts
+enum TileEdge : uint32_t { EDGE_WEST = 1, EDGE_EAST = 2, EDGE_NORTH = 4, EDGE_SOUTH = 8 };
+
+// a vertical strip hanging depth below each edge in edgeMask, facing out of the tile. Hides the cracks
+// where a neighbour uses another LOD (its edge has other vertices/heights). G and vertGrid as in
+// trimTileMesh; the new (skirt) vertices have no grid point and are not added to vertGrid
+void addTileSkirts(uint32_t G, uint32_t edgeMask, float depth,
+                   std::vector<float>& vertsXYZ, std::vector<uint32_t>& idx, const std::vector<uint32_t>& vertGrid);
+
+// plain "v x y z" / "f a b c" OBJ, 1-based indices
+void writeOBJ(const std::string& path, const std::vector<float>& vertsXYZ, const std::vector<uint32_t>& indices);
@@ -0,0 +1,153 @@
+#include "mini_json.h"
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+/*
+mini_json.cpp
+
+Recursive descent over the text: value -> object | array | string | number | literal.
+Depth is capped so a hostile file can't blow the stack.
+*/
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    for (const auto& kv : object) {
+        if (kv.first == key) return &kv.second;
+    }
+    return nullptr;
+}
+
+//helpers
+namespace {
+
+constexpr int MAX_DEPTH = 64;
+
+struct Parser {
+    const std::string& s;
+    size_t pos = 0;
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("JSON: " + what + " at byte " + std::to_string(pos));
+    }
+
+    void skipWs() {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r')) pos++;
+    }
+
+    bool consume(char c) {
+        skipWs();
+        if (pos < s.size() && s[pos] == c) { pos++; return true; }
+        return false;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("expected '") + c + "'");
+    }
+
+    std::string parseString() {
+        expect('"');
+        std::string out;
+        while (pos < s.size() && s[pos] != '"') {
+            char c = s[pos++];
+            if (c != '\\') { out += c; continue; }
+            if (pos >= s.size()) break;
+            char e = s[pos++];
+            switch (e) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    if (pos + 4 > s.size()) fail("bad \\u escape");
+                    const long code = std::strtol(s.substr(pos, 4).c_str(), nullptr, 16);
+                    pos += 4;
+                    out += code < 0x80 ? (char)code : '?';
+                    break;
+                }
+                default: fail("bad escape");
+            }
+        }
+        if (pos >= s.size()) fail("unterminated string");
+        pos++; // closing quote
+        return out;
+    }
+
+    JsonValue parseValue(int depth) {
+        if (depth > MAX_DEPTH) fail("nested too deep");
+        skipWs();
+        if (pos >= s.size()) fail("unexpected end");
+
+        JsonValue v;
+        const char c = s[pos];
+        if (c == '{') {
+            pos++;
+            v.type = JsonValue::Type::Object;
+            if (consume('}')) return v;
+            do {
+                skipWs();
+                std::string key = parseString();
+                expect(':');
+                v.object.emplace_back(std::move(key), parseValue(depth + 1));
+            } while (consume(','));
+            expect('}');
+        } else if (c == '[') {
+            pos++;
+            v.type = JsonValue::Type::Array;
+            if (consume(']')) return v;
+            do {
+                v.array.push_back(parseValue(depth + 1));
+            } while (consume(','));
+            expect(']');
+        } else if (c == '"') {
+            v.type = JsonValue::Type::String;
+            v.string = parseString();
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            const char* begin = s.c_str() + pos;
+            char* end = nullptr;
+            v.type = JsonValue::Type::Number;
+            v.number = std::strtod(begin, &end);
+            if (end == begin) fail("bad number");
+            pos += (size_t)(end - begin);
+        } else if (s.compare(pos, 4, "true") == 0) {
+            v.type = JsonValue::Type::Bool;
+            v.boolean = true;
+            pos += 4;
+        } else if (s.compare(pos, 5, "false") == 0) {
+            v.type = JsonValue::Type::Bool;
+            pos += 5;
+        } else if (s.compare(pos, 4, "null") == 0) {
+            pos += 4;
+        } else {
+            fail(std::string("unexpected '") + c + "'");
+        }
+        return v;
+    }
+};
+
+} // namespace
+
+JsonValue parseJson(const std::string& text) {
+    Parser p{ text };
+    JsonValue v = p.parseValue(0);
+    p.skipWs();
+    if (p.pos != text.size()) p.fail("trailing characters");
+    return v;
+}
+
+JsonValue readJsonFile(const std::string& path) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("Failed to open: " + path);
+    std::stringstream ss;
+    ss << f.rdbuf();
+    try {
+        return parseJson(ss.str());
+    } catch (const std::exception& e) {
+        throw std::runtime_error(std::string(e.what()) + " in " + path);
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+mini_json.h
+
+Just enough JSON for small config files (build --splat rules): objects, arrays, numbers, strings,
+true/false/null. No \u escapes beyond ASCII, no streaming. Errors throw std::runtime_error with the
+byte offset.
+*/
+
+struct JsonValue {
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    Type type = Type::Null;
+    bool boolean = false;
+    double number = 0.0;
+    std::string string;
+    std::vector<JsonValue> array;
+    std::vector<std::pair<std::string, JsonValue>> object; // in file order
+
+    bool isNumber() const { return type == Type::Number; }
+    bool isString() const { return type == Type::String; }
+    bool isArray() const { return type == Type::Array; }
+    bool isObject() const { return type == Type::Object; }
+
+    // object member, nullptr if missing (or not an object)
+    const JsonValue* find(const std::string& key) const;
+};
+
+JsonValue parseJson(const std::string& text);
+JsonValue readJsonFile(const std::string& path);
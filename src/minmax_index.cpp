@@ -0,0 +1,175 @@
+#include "minmax_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+/*
+minmax_index.cpp
+
+1) add: copy one tile/LOD's nodes (already built on the GPU by minmax.comp) into the flat node array
+2) write/read: header, entry table, node array. slots is rebuilt on read, not stored
+3) queryRect: walk down from the root, only into children that overlap the rect
+*/
+
+static constexpr char MINMAX_MAGIC[4] = { 'A', 'M', 'M', 'X' };
+static constexpr uint32_t MINMAX_VERSION = 2; // 2: + mapWidth/mapHeight. only the current version is read
+static constexpr uint64_t MINMAX_HEADER_BYTES = sizeof(MINMAX_MAGIC) + 9 * sizeof(uint32_t);
+static constexpr uint64_t MINMAX_ENTRY_BYTES = 4 * sizeof(uint32_t) + 2 * sizeof(uint16_t) + sizeof(uint32_t);
+
+uint32_t minMaxLevels(uint32_t size) {
+    uint32_t levels = 1;
+    while (levels < MINMAX_MAX_LEVELS && (size >> levels) >= MINMAX_LEAF_SIZE) levels++;
+    return levels;
+}
+uint32_t minMaxNodeCount(uint32_t levels) {
+    return ((1u << (2u * levels)) - 1u) / 3u;
+}
+
+//helpers
+static uint32_t levelOffset(uint32_t level) { return minMaxNodeCount(level); }
+static uint16_t nodeMin(uint32_t n) { return (uint16_t)(n & 0xFFFFu); }
+static uint16_t nodeMax(uint32_t n) { return (uint16_t)(n >> 16); }
+
+void MinMaxIndex::add(uint32_t tileX, uint32_t tileY, uint32_t lod, uint32_t levels, const uint32_t* tileNodes) {
+    if (tileX >= tilesX || tileY >= tilesY || lod >= lodCount) throw std::runtime_error("minmax index: tile out of range.");
+    slots.resize((size_t)tilesX * tilesY * lodCount, 0);
+
+    MinMaxEntry e;
+    e.tileX = tileX;
+    e.tileY = tileY;
+    e.lod = lod;
+    e.levels = levels;
+    e.minH = nodeMin(tileNodes[0]);
+    e.maxH = nodeMax(tileNodes[0]);
+    e.nodeOffset = (uint32_t)nodes.size();
+    nodes.insert(nodes.end(), tileNodes, tileNodes + minMaxNodeCount(levels));
+    entries.push_back(e);
+    slots[((size_t)tileY * tilesX + tileX) * lodCount + lod] = (uint32_t)entries.size();
+}
+
+const MinMaxEntry* MinMaxIndex::find(uint32_t tileX, uint32_t tileY, uint32_t lod) const {
+    if (tileX >= tilesX || tileY >= tilesY || lod >= lodCount) return nullptr;
+    const size_t s = ((size_t)tileY * tilesX + tileX) * lodCount + lod;
+    if (s >= slots.size() || slots[s] == 0) return nullptr;
+    return &entries[slots[s] - 1];
+}
+
+bool MinMaxIndex::queryRect(const MinMaxEntry& e, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1,
+                            uint16_t& outMin, uint16_t& outMax) const {
+    const uint32_t size = std::max(1u, tileSize >> e.lod);
+    x1 = std::min(x1, size);
+    y1 = std::min(y1, size);
+    if (x0 >= x1 || y0 >= y1) return false;
+
+    uint16_t mn = 0xFFFF, mx = 0;
+    const uint32_t* tree = nodes.data() + e.nodeOffset;
+    auto visit = [&](auto&& self, uint32_t level, uint32_t nx, uint32_t ny) -> void {
+        const uint32_t nodeSize = size >> level;
+        const uint32_t px0 = nx * nodeSize, py0 = ny * nodeSize;
+        const uint32_t px1 = px0 + nodeSize, py1 = py0 + nodeSize;
+        if (px1 <= x0 || py1 <= y0 || px0 >= x1 || py0 >= y1) return; // no overlap
+
+        const bool inside = px0 >= x0 && py0 >= y0 && px1 <= x1 && py1 <= y1;
+        if (inside || level + 1 == e.levels) {
+            const uint32_t n = tree[levelOffset(level) + ny * (1u << level) + nx];
+            mn = std::min(mn, nodeMin(n));
+            mx = std::max(mx, nodeMax(n));
+            return;
+        }
+        for (uint32_t c = 0; c < 4; c++) self(self, level + 1, nx * 2 + (c & 1), ny * 2 + (c >> 1));
+    };
+    visit(visit, 0, 0, 0);
+
+    outMin = mn;
+    outMax = mx;
+    return true;
+}
+
+void writeMinMaxIndex(const std::string& path, const MinMaxIndex& index) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) throw std::runtime_error("Failed to write: " + path);
+
+    const uint32_t header[9] = { MINMAX_VERSION, index.tileSize, index.tilesX, index.tilesY, index.lodCount,
+                                 (uint32_t)index.entries.size(), (uint32_t)index.nodes.size(),
+                                 index.mapWidth, index.mapHeight };
+    f.write(MINMAX_MAGIC, sizeof(MINMAX_MAGIC));
+    f.write(reinterpret_cast<const char*>(header), sizeof(header));
+    for (const auto& e : index.entries) {
+        const uint32_t a[4] = { e.tileX, e.tileY, e.lod, e.levels };
+        const uint16_t b[2] = { e.minH, e.maxH };
+        f.write(reinterpret_cast<const char*>(a), sizeof(a));
+        f.write(reinterpret_cast<const char*>(b), sizeof(b));
+        f.write(reinterpret_cast<const char*>(&e.nodeOffset), sizeof(e.nodeOffset));
+    }
+    f.write(reinterpret_cast<const char*>(index.nodes.data()), (std::streamsize)(index.nodes.size() * sizeof(uint32_t)));
+    if (!f) throw std::runtime_error("Failed to write: " + path);
+}
+
+// header -> index (no entries/nodes yet). f is opened at the end (ios::ate) for the file size, left at the entry table
+static MinMaxIndex readHeader(std::ifstream& f, const std::string& path, uint64_t& entryCount, uint64_t& nodeCount) {
+    const uint64_t fileBytes = (uint64_t)f.tellg();
+    f.seekg(0);
+
+    char magic[4]{};
+    uint32_t header[9]{};
+    f.read(magic, sizeof(magic));
+    f.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (!f || std::memcmp(magic, MINMAX_MAGIC, sizeof(magic)) != 0 || header[0] != MINMAX_VERSION)
+        throw std::runtime_error("Not a minmax index (or wrong version, rebuild it): " + path);
+
+    // check the counts against the file before allocating anything from them
+    entryCount = header[5];
+    nodeCount = header[6];
+    if (header[1] == 0 || header[2] == 0 || header[3] == 0 || header[4] == 0 || header[4] > 32 ||
+        (uint64_t)header[2] * header[3] * header[4] > (1u << 26) || // slots table, 256MB
+        header[7] == 0 || header[8] == 0 ||
+        header[7] > (uint64_t)header[1] * header[2] || header[8] > (uint64_t)header[1] * header[3] ||
+        MINMAX_HEADER_BYTES + entryCount * MINMAX_ENTRY_BYTES + nodeCount * sizeof(uint32_t) != fileBytes)
+        throw std::runtime_error("Corrupt minmax index: " + path);
+
+    MinMaxIndex index;
+    index.tileSize = header[1];
+    index.tilesX = header[2];
+    index.tilesY = header[3];
+    index.lodCount = header[4];
+    index.mapWidth = header[7];
+    index.mapHeight = header[8];
+    return index;
+}
+
+MinMaxIndex readMinMaxIndexHeader(const std::string& path) {
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f) throw std::runtime_error("Failed to open: " + path);
+    uint64_t entryCount = 0, nodeCount = 0;
+    return readHeader(f, path, entryCount, nodeCount);
+}
+
+MinMaxIndex readMinMaxIndex(const std::string& path) {
+    std::ifstream f(path, std::ios::binary | std::ios::ate);
+    if (!f) throw std::runtime_error("Failed to open: " + path);
+    uint64_t entryCount = 0, nodeCount = 0;
+    MinMaxIndex index = readHeader(f, path, entryCount, nodeCount);
+    index.entries.resize((size_t)entryCount);
+    index.nodes.resize((size_t)nodeCount);
+    index.slots.assign((size_t)index.tilesX * index.tilesY * index.lodCount, 0);
+
+    for (size_t i = 0; i < index.entries.size(); i++) {
+        auto& e = index.entries[i];
+        uint32_t a[4]{};
+        uint16_t b[2]{};
+        f.read(reinterpret_cast<char*>(a), sizeof(a));
+        f.read(reinterpret_cast<char*>(b), sizeof(b));
+        f.read(reinterpret_cast<char*>(&e.nodeOffset), sizeof(e.nodeOffset));
+        e.tileX = a[0]; e.tileY = a[1]; e.lod = a[2]; e.levels = a[3];
+        e.minH = b[0]; e.maxH = b[1];
+        if (e.tileX >= index.tilesX || e.tileY >= index.tilesY || e.lod >= index.lodCount || e.levels == 0 ||
+            e.levels > MINMAX_MAX_LEVELS || (size_t)e.nodeOffset + minMaxNodeCount(e.levels) > index.nodes.size())
+            throw std::runtime_error("Corrupt minmax index: " + path);
+        index.slots[((size_t)e.tileY * index.tilesX + e.tileX) * index.lodCount + e.lod] = (uint32_t)(i + 1);
+    }
+    f.read(reinterpret_cast<char*>(index.nodes.data()), (std::streamsize)(index.nodes.size() * sizeof(uint32_t)));
+    if (!f) throw std::runtime_error("Failed to read enough bytes: " + path);
+    return index;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+minmax_index.h
+
+Height bounds for every tile and LOD, written by build as <out>/minmax.index.
+Lets culling / LOD selection / collision ask "what is the height range here" without
+loading any lodN.height.raw.
+
+Each (tile, lod) has a min/max quadtree over its pixels: root = whole tile, every level
+splits each node in 4, leaves are MINMAX_LEAF_SIZE x MINMAX_LEAF_SIZE pixels (or the whole
+tile when it is smaller). Nodes are stored root first, level k has (2^k)^2 nodes row-major
+starting at (4^k - 1) / 3, each packed as min | (max << 16). Same layout minmax.comp writes.
+
+It is also where build records the map itself (tile size, source heightmap size), so readers
+know which edge pixels are padding when the map is not a multiple of the tile size.
+
+File (little endian):
+  char[4] "AMMX", u32 version, u32 tileSize, u32 tilesX, u32 tilesY, u32 lodCount,
+  u32 entryCount, u32 nodeCount, u32 mapWidth, u32 mapHeight   (version 2, older files are rejected)
+  MinMaxEntry[entryCount]
+  u32 nodes[nodeCount]
+Entries and their nodes are in build order: tiles in Morton (Z) order (morton.h), all LODs of a
+tile together, so a spatial neighbourhood is one mostly contiguous read.
+*/
+
+static constexpr uint32_t MINMAX_LEAF_SIZE = 8;   // smallest leaf. big tiles get bigger leaves (MINMAX_MAX_LEVELS)
+static constexpr uint32_t MINMAX_MAX_LEVELS = 6; // 1365 nodes, what one minmax.comp workgroup holds
+
+// quadtree depth for a tile of `size` pixels at some LOD
+uint32_t minMaxLevels(uint32_t size);
+// nodes in a quadtree with `levels` levels
+uint32_t minMaxNodeCount(uint32_t levels);
+
+struct MinMaxEntry {
+    uint32_t tileX = 0;
+    uint32_t tileY = 0;
+    uint32_t lod = 0;
+    uint32_t levels = 0;     // quadtree depth
+    uint16_t minH = 0;       // whole tile, raw u16 heights
+    uint16_t maxH = 0;
+    uint32_t nodeOffset = 0; // first (root) node in MinMaxIndex::nodes
+};
+
+struct MinMaxIndex {
+    uint32_t tileSize = 0; // LOD0 pixels per tile side
+    uint32_t tilesX = 0;
+    uint32_t tilesY = 0;
+    uint32_t lodCount = 0;
+    uint32_t mapWidth = 0;  // source heightmap, tilesX * tileSize or less
+    uint32_t mapHeight = 0;
+    std::vector<MinMaxEntry> entries;
+    std::vector<uint32_t> nodes;
+    std::vector<uint32_t> slots; // (tileY * tilesX + tileX) * lodCount + lod -> entry + 1 (0 = not built)
+
+    // append one tile/LOD, nodes as read back from minmax.comp. tilesX/tilesY/lodCount must be set first
+    void add(uint32_t tileX, uint32_t tileY, uint32_t lod, uint32_t levels, const uint32_t* tileNodes);
+
+    // nullptr if that tile/LOD was not built
+    const MinMaxEntry* find(uint32_t tileX, uint32_t tileY, uint32_t lod) const;
+
+    // bounds of pixels [x0,x1) x [y0,y1) of one tile at e's LOD. Nodes fully inside the rect are exact,
+    // leaves that only overlap it count whole, so the answer can be a little wider than the true range.
+    // false if the rect is empty
+    bool queryRect(const MinMaxEntry& e, uint32_t x0, uint32_t y0, uint32_t x1, uint32_t y1,
+                   uint16_t& outMin, uint16_t& outMax) const;
+};
+
+void writeMinMaxIndex(const std::string& path, const MinMaxIndex& index);
+MinMaxIndex readMinMaxIndex(const std::string& path);
+// just the header fields (tile size, tile counts, map size). entries/nodes stay empty
+MinMaxIndex readMinMaxIndexHeader(const std::string& path);
@@ -0,0 +1,50 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/*
+morton.h
+
+Z-order (Morton) tile order: interleave the bits of x and y so tiles that are close in 2D are
+close in the list too. Used for build's dispatch order, export's job order and the entry order
+of minmax.index, so neighbour border reads and tile caches keep hitting recently touched tiles.
+
+ 0 1 4 5
+ 2 3 6 7
+ 8 9 C D
+ A B E F
+*/
+
+// spread the 32 bits of v over the even bits of a 64 bit value
+inline uint64_t mortonSpreadBits(uint32_t v) {
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8))  & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4))  & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2))  & 0x3333333333333333ull;
+    x = (x | (x << 1))  & 0x5555555555555555ull;
+    return x;
+}
+
+inline uint64_t mortonEncode(uint32_t x, uint32_t y) {
+    return mortonSpreadBits(x) | (mortonSpreadBits(y) << 1);
+}
+
+struct TileXY {
+    uint32_t x = 0;
+    uint32_t y = 0;
+};
+
+// every tile of a tilesX x tilesY grid in Z-order. Works for any (non square, non power of two) grid
+inline std::vector<TileXY> mortonTileOrder(uint32_t tilesX, uint32_t tilesY) {
+    std::vector<TileXY> tiles;
+    tiles.reserve((size_t)tilesX * tilesY);
+    for (uint32_t y = 0; y < tilesY; y++) {
+        for (uint32_t x = 0; x < tilesX; x++) tiles.push_back(TileXY{ x, y });
+    }
+    std::sort(tiles.begin(), tiles.end(), [](const TileXY& a, const TileXY& b) {
+        return mortonEncode(a.x, a.y) < mortonEncode(b.x, b.y);
+    });
+    return tiles;
+}
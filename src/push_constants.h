@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+
+/*
+push_constants.h
+
+Push constant blocks of the tile kernels, shared by build, autotune and the bench so they can't
+drift from each other or from the shaders (their layout(push_constant) blocks).
+The pipeline layout reserves 32 bytes, the biggest (PCNormals) is 24.
+*/
+
+// extract_tile.comp
+struct PCExtract
+{
+    uint32_t hmWidth; //tell GPU how wide orignical big img is to calc where next row starts
+    uint32_t hmHeight; //edge tiles clamp to the last row
+    uint32_t tileX;//tell gpu which exact sqr to cut
+    uint32_t tileY;
+};
+
+// downsample.comp
+struct PCDownsample
+{
+    uint32_t inSize;
+};
+
+// minmax.comp
+struct PCMinMax
+{
+    uint32_t inSize;
+    uint32_t levels; // see minMaxLevels
+};
+
+// normals.comp and splat.comp
+struct PCNormals
+{
+    uint32_t hmWidth;
+    uint32_t hmHeight;
+    uint32_t tileX;
+    uint32_t tileY;
+    uint32_t step;   // 1 << lod
+    float strength;
+};
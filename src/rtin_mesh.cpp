@@ -0,0 +1,189 @@
+#include "rtin_mesh.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+/*
+rtin_mesh.cpp
+
+1) constructor: walk the implicit binary tree of right triangles once per grid size
+   (shared by every tile, read only so worker threads can use it at the same time)
+2) computeErrors: bottom-up. error(midpoint) = max(own interpolation error, children errors)
+   so a split always drags its parents in with it (no T-junctions inside a tile)
+3) extract: top-down from the two root triangles, stop splitting when error <= maxError
+*/
+
+//check 2^k + 1
+static bool isPow2Plus1(uint32_t n) {
+    const uint32_t t = n - 1;
+    return n >= 3 && (t & (t - 1)) == 0;
+}
+
+RtinTriangulator::RtinTriangulator(uint32_t gridSize) : size_(gridSize) {
+    if (!isPow2Plus1(gridSize)) throw std::runtime_error("RTIN grid size must be 2^k + 1.");
+
+    const uint32_t tileSize = gridSize - 1;
+    numTriangles_ = tileSize * tileSize * 2 - 2;
+    numParentTriangles_ = numTriangles_ - tileSize * tileSize;
+    coords_.resize((size_t)numTriangles_ * 4);
+
+    //triangle id encodes the path from the root: low bit = which root, then left/right per level
+    for (uint32_t i = 0; i < numTriangles_; i++) {
+        uint32_t id = i + 2;
+        uint32_t ax = 0, ay = 0, bx = 0, by = 0, cx = 0, cy = 0;
+        if (id & 1) {
+            bx = by = cx = tileSize; // bottom-left root
+        } else {
+            ax = ay = cy = tileSize; // top-right root
+        }
+        while ((id >>= 1) > 1) {
+            const uint32_t mx = (ax + bx) >> 1;
+            const uint32_t my = (ay + by) >> 1;
+            if (id & 1) { // left half
+                bx = ax; by = ay;
+                ax = cx; ay = cy;
+            } else {      // right half
+                ax = bx; ay = by;
+                bx = cx; by = cy;
+            }
+            cx = mx; cy = my;
+        }
+        const size_t k = (size_t)i * 4;
+        coords_[k + 0] = (uint16_t)ax;
+        coords_[k + 1] = (uint16_t)ay;
+        coords_[k + 2] = (uint16_t)bx;
+        coords_[k + 3] = (uint16_t)by;
+    }
+}
+
+void RtinTriangulator::computeErrors(const std::vector<float>& heights, std::vector<float>& errors) const {
+    const uint32_t size = size_;
+    const uint32_t max = size - 1;
+    if (heights.size() != (size_t)size * size) throw std::runtime_error("RTIN heights have the wrong size.");
+
+    errors.assign((size_t)size * size, 0.0f);
+
+    //lock the border so neighbours always agree on their shared edge
+    const float inf = std::numeric_limits<float>::infinity();
+    for (uint32_t i = 0; i < size; i++) {
+        errors[i] = inf;                        // top row
+        errors[(size_t)max * size + i] = inf;   // bottom row
+        errors[(size_t)i * size] = inf;         // left column
+        errors[(size_t)i * size + max] = inf;   // right column
+    }
+
+    //smallest triangles first so children are done before their parents
+    for (uint32_t i = numTriangles_; i-- > 0;) {
+        const size_t k = (size_t)i * 4;
+        const uint32_t ax = coords_[k + 0], ay = coords_[k + 1];
+        const uint32_t bx = coords_[k + 2], by = coords_[k + 3];
+        const uint32_t mx = (ax + bx) >> 1;
+        const uint32_t my = (ay + by) >> 1;
+        const uint32_t cx = mx + my - ay;
+        const uint32_t cy = my + ax - mx;
+
+        const float interpolated = (heights[(size_t)ay * size + ax] + heights[(size_t)by * size + bx]) * 0.5f;
+        const size_t middle = (size_t)my * size + mx;
+        float& e = errors[middle];
+        e = std::max(e, std::fabs(interpolated - heights[middle]));
+
+        if (i < numParentTriangles_) {
+            const size_t left = (size_t)((ay + cy) >> 1) * size + ((ax + cx) >> 1);
+            const size_t right = (size_t)((by + cy) >> 1) * size + ((bx + cx) >> 1);
+            e = std::max(e, std::max(errors[left], errors[right]));
+        }
+    }
+}
+
+void RtinTriangulator::extract(const std::vector<float>& errors, float maxError,
+                               std::vector<uint32_t>& outVertGrid, std::vector<uint32_t>& outIdx) const {
+    std::vector<uint32_t> remap;
+    extract(errors, maxError, outVertGrid, outIdx, remap);
+}
+
+void RtinTriangulator::extract(const std::vector<float>& errors, float maxError,
+                               std::vector<uint32_t>& outVertGrid, std::vector<uint32_t>& outIdx,
+                               std::vector<uint32_t>& remap) const {
+    const uint32_t size = size_;
+    const uint32_t max = size - 1;
+
+    outVertGrid.clear();
+    outIdx.clear();
+    remap.assign((size_t)size * size, 0); // grid index -> vertex index + 1 (0 = not emitted yet)
+
+    auto vertex = [&](uint32_t x, uint32_t y) -> uint32_t {
+        const uint32_t g = y * size + x;
+        if (remap[g] == 0) {
+            outVertGrid.push_back(g);
+            remap[g] = (uint32_t)outVertGrid.size();
+        }
+        return remap[g] - 1;
+    };
+
+    //a,b = hypotenuse, c = right angle corner
+    auto process = [&](auto&& self, uint32_t ax, uint32_t ay, uint32_t bx, uint32_t by,
+                       uint32_t cx, uint32_t cy) -> void {
+        const uint32_t mx = (ax + bx) >> 1;
+        const uint32_t my = (ay + by) >> 1;
+        const uint32_t legLen = (ax > cx ? ax - cx : cx - ax) + (ay > cy ? ay - cy : cy - ay);
+
+        if (legLen > 1 && errors[(size_t)my * size + mx] > maxError) {
+            self(self, cx, cy, ax, ay, mx, my);
+            self(self, bx, by, cx, cy, mx, my);
+            return;
+        }
+
+        //same winding as the regular grid: (x,z) -> (x,z+1) -> (x+1,z)
+        const int64_t cross = (int64_t(bx) - ax) * (int64_t(cy) - ay) - (int64_t(by) - ay) * (int64_t(cx) - ax);
+        const uint32_t a = vertex(ax, ay);
+        const uint32_t b = vertex(bx, by);
+        const uint32_t c = vertex(cx, cy);
+        outIdx.push_back(a);
+        if (cross < 0) { outIdx.push_back(b); outIdx.push_back(c); }
+        else           { outIdx.push_back(c); outIdx.push_back(b); }
+    };
+
+    process(process, 0, 0, max, max, max, 0);
+    process(process, max, max, 0, 0, 0, max);
+}
+
+void buildRtinMeshFromHeightU16(const RtinTriangulator& rtin, const std::vector<uint16_t>& h,
+                                float spacing, float heightScale, float baseX, float baseZ, float maxError,
+                                std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx,
+                                std::vector<uint32_t>* outVertGrid)
+{
+    RtinScratch scratch;
+    buildRtinMeshFromHeightU16(rtin, h, spacing, heightScale, baseX, baseZ, maxError, outVertsXYZ, outIdx, scratch);
+    if (outVertGrid) *outVertGrid = std::move(scratch.vertGrid);
+}
+
+void buildRtinMeshFromHeightU16(const RtinTriangulator& rtin, const std::vector<uint16_t>& h,
+                                float spacing, float heightScale, float baseX, float baseZ, float maxError,
+                                std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx,
+                                RtinScratch& scratch)
+{
+    const uint32_t size = rtin.gridSize();
+
+    //errors are measured in output units so --max-error means meters (or whatever --scale is in)
+    std::vector<float>& heights = scratch.heights;
+    heights.resize(h.size());
+    for (size_t i = 0; i < h.size(); i++) heights[i] = float(h[i]) / 65535.0f * heightScale;
+
+    rtin.computeErrors(heights, scratch.errors);
+
+    const std::vector<uint32_t>& vertGrid = scratch.vertGrid;
+    rtin.extract(scratch.errors, maxError, scratch.vertGrid, outIdx, scratch.remap);
+
+    outVertsXYZ.resize(vertGrid.size() * 3);
+    for (size_t v = 0; v < vertGrid.size(); v++) {
+        const uint32_t g = vertGrid[v];
+        const uint32_t x = g % size;
+        const uint32_t z = g / size;
+        outVertsXYZ[v * 3 + 0] = float(x) * spacing + baseX;
+        outVertsXYZ[v * 3 + 1] = heights[g];
+        outVertsXYZ[v * 3 + 2] = float(z) * spacing + baseZ;
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+/*
+rtin_mesh.h
+
+Right-Triangulated Irregular Network (RTIN) for error-bounded tile meshes.
+The grid must be (2^k + 1) x (2^k + 1) heights, e.g. a 256 tile plus one border
+row/column borrowed from the east/south neighbours (257 x 257).
+
+Every triangle is split at its hypotenuse midpoint until the height error at that
+midpoint is <= maxError, so flat areas get a few big triangles and ridges stay dense.
+
+Border vertices are always kept (locked), so two neighbouring tiles emit exactly the
+same vertices along their shared edge and there are no cracks between them.
+*/
+
+class RtinTriangulator {
+public:
+    explicit RtinTriangulator(uint32_t gridSize); // 2^k + 1
+
+    uint32_t gridSize() const { return size_; }
+
+    // per vertex error (same units as heights). Border vertices get +inf
+    void computeErrors(const std::vector<float>& heights, std::vector<float>& errors) const;
+
+    // emit triangles whose error is within maxError.
+    // outVertGrid = grid index (z * gridSize + x) of every emitted vertex, outIdx = 3 per triangle
+    void extract(const std::vector<float>& errors, float maxError,
+                 std::vector<uint32_t>& outVertGrid, std::vector<uint32_t>& outIdx) const;
+    // same, with a caller owned grid index -> vertex lookup (gridSize^2) so repeated calls don't allocate
+    void extract(const std::vector<float>& errors, float maxError,
+                 std::vector<uint32_t>& outVertGrid, std::vector<uint32_t>& outIdx,
+                 std::vector<uint32_t>& remap) const;
+
+private:
+    uint32_t size_ = 0;
+    uint32_t numTriangles_ = 0;
+    uint32_t numParentTriangles_ = 0;
+    std::vector<uint16_t> coords_; // ax, ay, bx, by for every triangle in the full hierarchy
+};
+
+// per tile working memory. Keep one per worker (or per pooled buffer) and the RTIN path stops
+// allocating once the vectors have grown to their largest size
+struct RtinScratch {
+    std::vector<float> heights;
+    std::vector<float> errors;
+    std::vector<uint32_t> remap;
+    std::vector<uint32_t> vertGrid; // grid index of every emitted vertex (see outVertGrid below)
+};
+
+// heights: gridSize^2 u16 values. Vertices are placed like the regular grid exporter
+// (x/z = grid * spacing + base, y = h / 65535 * heightScale). maxError is in the same units as y.
+// outVertGrid (optional) gets the grid index of every vertex, for welding tiles together
+void buildRtinMeshFromHeightU16(const RtinTriangulator& rtin, const std::vector<uint16_t>& h,
+                                float spacing, float heightScale, float baseX, float baseZ, float maxError,
+                                std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx,
+                                std::vector<uint32_t>* outVertGrid = nullptr);
+void buildRtinMeshFromHeightU16(const RtinTriangulator& rtin, const std::vector<uint16_t>& h,
+                                float spacing, float heightScale, float baseX, float baseZ, float maxError,
+                                std::vector<float>& outVertsXYZ, std::vector<uint32_t>& outIdx,
+                                RtinScratch& scratch);
@@ -0,0 +1,19 @@
+#pragma once
+#include <utility>
+
+// --- Scope guard ---
+// runs fn when it goes out of scope, also when an exception unwinds past it.
+// build and the terrain filters use it for their Vulkan handles, so a throw halfway through setup (missing .spv)
+// still destroys whatever was created. fn must not throw
+template <typename Fn>
+class ScopeExit {
+public:
+    explicit ScopeExit(Fn fn) : fn_(std::move(fn)) {}
+    ~ScopeExit() { fn_(); }
+
+    ScopeExit(const ScopeExit&) = delete;
+    ScopeExit& operator=(const ScopeExit&) = delete;
+
+private:
+    Fn fn_;
+};
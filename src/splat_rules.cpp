@@ -0,0 +1,97 @@
+#include "splat_rules.h"
+#include "mini_json.h"
+
+#include <cstring>
+#include <stdexcept>
+
+/*
+splat_rules.cpp
+
+1) loadSplatRules: rules.json -> SplatRules (format in splat_rules.h), checked so the shader never
+   sees an empty or inverted range
+2) makeSplatSpec: rules -> specialization constants (floats passed as their bits)
+*/
+
+//helpers
+static float numberOr(const JsonValue* v, float fallback, const std::string& what) {
+    if (!v) return fallback;
+    if (!v->isNumber()) throw std::runtime_error("splat rules: " + what + " must be a number.");
+    return (float)v->number;
+}
+
+static SplatRange readRange(const JsonValue* v, const std::string& what) {
+    SplatRange r;
+    if (!v) return r;
+    if (v->isObject()) {
+        r.min = numberOr(v->find("min"), r.min, what + ".min");
+        r.max = numberOr(v->find("max"), r.max, what + ".max");
+        r.blend = numberOr(v->find("blend"), r.blend, what + ".blend");
+    } else if (v->isArray() && (v->array.size() == 2 || v->array.size() == 3)) {
+        r.min = numberOr(&v->array[0], r.min, what + "[0]");
+        r.max = numberOr(&v->array[1], r.max, what + "[1]");
+        if (v->array.size() == 3) r.blend = numberOr(&v->array[2], r.blend, what + "[2]");
+    } else {
+        throw std::runtime_error("splat rules: " + what + " must be {min, max, blend} or [min, max, blend].");
+    }
+    if (r.min > r.max) throw std::runtime_error("splat rules: " + what + " has min > max.");
+    if (r.blend < 0.0f) throw std::runtime_error("splat rules: " + what + ".blend must be >= 0.");
+    return r;
+}
+
+SplatRules loadSplatRules(const std::string& path) {
+    const JsonValue root = readJsonFile(path);
+    const JsonValue* mats = root.find("materials");
+    if (!mats || !mats->isArray() || mats->array.empty()) {
+        throw std::runtime_error("splat rules need a non empty \"materials\" array: " + path);
+    }
+    if (mats->array.size() > SPLAT_MAX_MATERIALS) {
+        throw std::runtime_error("splat rules: at most 4 materials (one per RGBA channel): " + path);
+    }
+
+    SplatRules rules;
+    for (size_t i = 0; i < mats->array.size(); i++) {
+        const JsonValue& m = mats->array[i];
+        if (!m.isObject()) throw std::runtime_error("splat rules: materials[" + std::to_string(i) + "] must be an object.");
+
+        SplatMaterial mat;
+        const JsonValue* name = m.find("name");
+        mat.name = name && name->isString() ? name->string : "material" + std::to_string(i);
+        mat.height = readRange(m.find("height"), mat.name + ".height");
+        mat.slope = readRange(m.find("slope"), mat.name + ".slope");
+        mat.curvature = readRange(m.find("curvature"), mat.name + ".curvature");
+        rules.materials.push_back(mat);
+    }
+    return rules;
+}
+
+void makeSplatSpec(uint32_t tileSize, const KernelConfig& cfg, const SplatRules& rules, SplatSpec& out) {
+    out.values.clear();
+    out.entries.clear();
+    auto add = [&](uint32_t id, uint32_t bits) {
+        out.entries.push_back(VkSpecializationMapEntry{ id, (uint32_t)(out.values.size() * sizeof(uint32_t)), sizeof(uint32_t) });
+        out.values.push_back(bits);
+    };
+    auto addFloat = [&](uint32_t id, float f) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &f, sizeof(bits));
+        add(id, bits);
+    };
+
+    add(0, tileSize);
+    add(1, cfg.localX);
+    add(2, cfg.localY);
+    add(3, cfg.rows);
+    add(4, (uint32_t)rules.materials.size());
+    for (uint32_t m = 0; m < (uint32_t)rules.materials.size(); m++) {
+        const SplatMaterial& mat = rules.materials[m];
+        const SplatRange* ranges[3] = { &mat.height, &mat.slope, &mat.curvature };
+        for (uint32_t q = 0; q < 3; q++) {
+            const uint32_t id = 8 + m * 9 + q * 3;
+            addFloat(id + 0, ranges[q]->min);
+            addFloat(id + 1, ranges[q]->max);
+            addFloat(id + 2, ranges[q]->blend);
+        }
+    }
+    out.info = VkSpecializationInfo{ (uint32_t)out.entries.size(), out.entries.data(),
+                                     out.values.size() * sizeof(uint32_t), out.values.data() };
+}
@@ -0,0 +1,61 @@
+#pragma once
+#include "kernel_profile.h"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+splat_rules.h
+
+build --splat rules.json: up to 4 materials, each with optional height / slope / curvature ranges.
+splat.comp scores every pixel against every material, normalizes the scores and writes them as one
+RGBA8 mask per tile and LOD (lodN.splat.png: r = material 0, g = 1, b = 2, a = 3).
+
+{
+  "materials": [
+    { "name": "sand",  "height": { "max": 0.12, "blend": 0.02 } },
+    { "name": "grass", "slope": { "max": 30, "blend": 5 }, "curvature": { "min": -0.5 } },
+    { "name": "rock",  "slope": { "min": 30, "blend": 5 } },
+    { "name": "snow",  "height": [0.75, 1.0, 0.05] }
+  ]
+}
+
+height: 0..1 of the heightmap range. slope: degrees, using --normal-strength (scale / spacing).
+curvature: laplacian of the height in the same units, > 0 in hollows/valleys, < 0 on ridges.
+A range is { "min", "max", "blend" } or [min, max(, blend)], every field optional. blend softens both
+edges by that much on each side. A pixel no material wants goes to material 0.
+At LOD > 0 a pixel's height is the mean of its step*step block, like lodN.height.raw. The weights
+are rounded on their running total, so r + g + b + a is always exactly 255.
+*/
+
+static constexpr uint32_t SPLAT_MAX_MATERIALS = 4;
+
+struct SplatRange {
+    float min = -1e30f; // +-1e30 = open ended
+    float max = 1e30f;
+    float blend = 0.0f;
+};
+
+struct SplatMaterial {
+    std::string name;
+    SplatRange height;
+    SplatRange slope;
+    SplatRange curvature;
+};
+
+struct SplatRules {
+    std::vector<SplatMaterial> materials;
+};
+
+SplatRules loadSplatRules(const std::string& path);
+
+// specialization constants for splat.comp: 0..3 like every tile kernel (kernel_profile.h),
+// 4 = material count, 8 + material * 9 + (height, slope, curvature) * 3 + (min, max, blend)
+struct SplatSpec {
+    std::vector<uint32_t> values;
+    std::vector<VkSpecializationMapEntry> entries;
+    VkSpecializationInfo info{};
+};
+void makeSplatSpec(uint32_t tileSize, const KernelConfig& cfg, const SplatRules& rules, SplatSpec& out);
@@ -0,0 +1,301 @@
+#include "terrain_filter.h"
+#include "scope_exit.h"
+#include "trace.h"
+
+#include <stdexcept>
+
+/*
+terrain_filter.cpp
+
+1) hmBuf -> float working buffer A (filter_convert.comp)
+2) each step ping-pongs A <-> B:
+   smooth:R    -> smooth.comp along x, then along y (gaussian, shared memory block + R pixel halo)
+   thermal:N   -> thermal_erosion.comp N times
+   hydraulic:N -> hydraulic_erosion.comp N times (vec4 per pixel: height, water, sediment)
+3) working buffer -> hmBuf, so extract/normals/minmax see the filtered map
+
+Every pass reads what the previous one wrote, so they are recorded back to back with a barrier in
+between and submitted in batches (one wait per batch, not per dispatch). Working buffers are device
+local, the CPU never touches them.
+*/
+
+//helpers
+struct PCConvert
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t toFloat;
+};
+
+struct PCSmooth
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t radius;
+    uint32_t axis;
+};
+
+struct PCThermal
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    float talus;
+    float rate;
+};
+
+struct PCHydraulic
+{
+    uint32_t width;
+    uint32_t height;
+    uint32_t stride;
+    uint32_t phase;  // bit 0 first iteration, bit 1 last
+    float rain;
+    float capacity;
+    float erode;
+    float deposit;
+};
+
+static constexpr uint32_t SMOOTH_MAX_RADIUS = 16; // smooth.comp MAX_RADIUS
+static constexpr uint32_t FILTER_GROUP = 16;      // 16x16 in every filter shader
+static constexpr uint32_t DISPATCHES_PER_SUBMIT = 64; // keeps one submit well under driver timeouts on big maps
+
+// Both working buffers are bound whole and the shaders index them with a 32 bit (y*width+x)*stride.
+// Past maxStorageBufferRange (at most 4 GB, so < 2^30 floats) that wraps or reads garbage, and two of
+// them have to fit in device memory next to hmBuf. Catch it here with a message, not on the GPU
+static void checkWorkBuffers(VkPhysicalDevice physicalDevice, uint32_t width, uint32_t height,
+                             VkDeviceSize hmBytes, VkDeviceSize workBytes, bool hydraulic)
+{
+    const std::string what = std::string("map too large for --filter") + (hydraulic ? " hydraulic" : "") + " ("
+        + std::to_string(width) + "x" + std::to_string(height) + ", " + std::to_string(workBytes >> 20) + " MB per working buffer): ";
+
+    VkPhysicalDeviceProperties props{};
+    vkGetPhysicalDeviceProperties(physicalDevice, &props);
+    if (workBytes > props.limits.maxStorageBufferRange) {
+        throw std::runtime_error(what + "the GPU binds at most " + std::to_string(props.limits.maxStorageBufferRange >> 20) + " MB per buffer.");
+    }
+
+    VkPhysicalDeviceMemoryProperties mem{};
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &mem);
+    VkDeviceSize deviceLocal = 0; // biggest device local heap. total size, the real free space can be less
+    for (uint32_t i = 0; i < mem.memoryHeapCount; i++) {
+        if ((mem.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && mem.memoryHeaps[i].size > deviceLocal) {
+            deviceLocal = mem.memoryHeaps[i].size;
+        }
+    }
+    if (hmBytes + 2 * workBytes > deviceLocal) {
+        throw std::runtime_error(what + "needs " + std::to_string((hmBytes + 2 * workBytes) >> 20) + " MB of GPU memory, the GPU has "
+            + std::to_string(deviceLocal >> 20) + " MB.");
+    }
+}
+
+std::vector<FilterStep> parseFilterSteps(const std::string& s)
+{
+    std::vector<FilterStep> out;
+    size_t start = 0;
+    while (start < s.size()) {
+        size_t comma = s.find(',', start);
+        if (comma == std::string::npos) comma = s.size();
+        const std::string item = s.substr(start, comma - start);
+        start = comma + 1;
+
+        const size_t colon = item.find(':');
+        const std::string name = item.substr(0, colon);
+        FilterStep step;
+        if (name == "smooth") step.kind = FilterKind::Smooth;
+        else if (name == "thermal") step.kind = FilterKind::Thermal;
+        else if (name == "hydraulic") step.kind = FilterKind::Hydraulic;
+        else throw std::runtime_error("Unknown filter '" + name + "' (smooth, thermal, hydraulic).");
+
+        if (colon != std::string::npos) step.amount = (uint32_t)std::stoul(item.substr(colon + 1));
+        if (step.amount == 0) throw std::runtime_error("Filter amount must be at least 1: " + item);
+        if (step.kind == FilterKind::Smooth && step.amount > SMOOTH_MAX_RADIUS) {
+            throw std::runtime_error("smooth radius is at most 16 (repeat the step for more): " + item);
+        }
+        out.push_back(step);
+    }
+    return out;
+}
+
+void runTerrainFilters(VkDevice device,
+                       VkPhysicalDevice physicalDevice,
+                       VkQueue queue,
+                       VkCommandPool cmdPool,
+                       VkDescriptorSetLayout setLayout,
+                       VkPipelineLayout pipelineLayout,
+                       const Buffer& hmBuf,
+                       uint32_t width,
+                       uint32_t height,
+                       const std::vector<FilterStep>& steps,
+                       const TerrainFilterParams& params)
+{
+    if (steps.empty()) return;
+    TraceSpan span("filters");
+
+    bool hydraulic = false;
+    for (const FilterStep& s : steps) hydraulic |= s.kind == FilterKind::Hydraulic;
+    const uint32_t stride = hydraulic ? 4 : 1; // floats per pixel
+    const VkDeviceSize hmBytes = sizeof(uint32_t) * (VkDeviceSize)width * height;
+    const VkDeviceSize workBytes = hmBytes * stride;
+    checkWorkBuffers(physicalDevice, width, height, hmBytes, workBytes, hydraulic);
+
+    // everything starts empty, the guard destroys what got created (also when a shader is missing halfway)
+    VkShaderModule modConvert = VK_NULL_HANDLE, modSmooth = VK_NULL_HANDLE;
+    VkShaderModule modThermal = VK_NULL_HANDLE, modHydraulic = VK_NULL_HANDLE;
+    VkPipeline pipeConvert = VK_NULL_HANDLE, pipeSmooth = VK_NULL_HANDLE;
+    VkPipeline pipeThermal = VK_NULL_HANDLE, pipeHydraulic = VK_NULL_HANDLE;
+    Buffer workA{}, workB{};
+    VkDescriptorPool descPool = VK_NULL_HANDLE;
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+
+    // ---- Cleanup (on return or throw) ----
+    ScopeExit cleanup([&] {
+        vkQueueWaitIdle(queue); // a batch may still be in flight
+        if (cmd) vkFreeCommandBuffers(device, cmdPool, 1, &cmd);
+        if (descPool) vkDestroyDescriptorPool(device, descPool, nullptr);
+        for (VkPipeline p : { pipeConvert, pipeSmooth, pipeThermal, pipeHydraulic }) if (p) vkDestroyPipeline(device, p, nullptr);
+        for (VkShaderModule m : { modConvert, modSmooth, modThermal, modHydraulic }) if (m) vkDestroyShaderModule(device, m, nullptr);
+        for (const Buffer* b : { &workA, &workB }) {
+            if (b->buffer) vkDestroyBuffer(device, b->buffer, nullptr);
+            if (b->memory) vkFreeMemory(device, b->memory, nullptr);
+        }
+    });
+
+    // ---- pipelines (only the ones the steps use) ----
+    pipeConvert = makeComputePipeline(device, pipelineLayout, shaderPath("filter_convert.comp.spv"), &modConvert);
+    for (const FilterStep& s : steps) {
+        if (s.kind == FilterKind::Smooth && !pipeSmooth) {
+            pipeSmooth = makeComputePipeline(device, pipelineLayout, shaderPath("smooth.comp.spv"), &modSmooth);
+        } else if (s.kind == FilterKind::Thermal && !pipeThermal) {
+            pipeThermal = makeComputePipeline(device, pipelineLayout, shaderPath("thermal_erosion.comp.spv"), &modThermal);
+        } else if (s.kind == FilterKind::Hydraulic && !pipeHydraulic) {
+            pipeHydraulic = makeComputePipeline(device, pipelineLayout, shaderPath("hydraulic_erosion.comp.spv"), &modHydraulic);
+        }
+    }
+
+    // ---- working buffers A/B (sizes checked up top) ----
+    workA = createBuffer(device, physicalDevice, workBytes,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    workB = createBuffer(device, physicalDevice, workBytes,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    // ---- one descriptor set per direction, so a batch never has to update a bound set ----
+    enum { SET_HM_TO_A, SET_A_TO_B, SET_B_TO_A, SET_A_TO_HM, SET_B_TO_HM, SET_COUNT };
+    VkDescriptorPoolSize ps{ VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * SET_COUNT };
+    VkDescriptorPoolCreateInfo poolInfo{ VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO };
+    poolInfo.maxSets = SET_COUNT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &ps;
+    vkCheck(vkCreateDescriptorPool(device, &poolInfo, nullptr, &descPool), "vkCreateDescriptorPool(filters)");
+
+    std::vector<VkDescriptorSetLayout> layouts(SET_COUNT, setLayout);
+    VkDescriptorSetAllocateInfo ai{ VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    ai.descriptorPool = descPool;
+    ai.descriptorSetCount = SET_COUNT;
+    ai.pSetLayouts = layouts.data();
+    VkDescriptorSet sets[SET_COUNT]{};
+    vkCheck(vkAllocateDescriptorSets(device, &ai, sets), "vkAllocateDescriptorSets(filters)");
+
+    auto bind2 = [&](VkDescriptorSet set, const Buffer& in, const Buffer& out) {
+        VkDescriptorBufferInfo inInfo{ in.buffer, 0, in.size };
+        VkDescriptorBufferInfo outInfo{ out.buffer, 0, out.size };
+        VkWriteDescriptorSet w[2]{};
+        for (int i = 0; i < 2; i++) {
+            w[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            w[i].dstSet = set;
+            w[i].dstBinding = (uint32_t)i;
+            w[i].descriptorCount = 1;
+            w[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            w[i].pBufferInfo = i == 0 ? &inInfo : &outInfo;
+        }
+        vkUpdateDescriptorSets(device, 2, w, 0, nullptr);
+    };
+    bind2(sets[SET_HM_TO_A], hmBuf, workA);
+    bind2(sets[SET_A_TO_B], workA, workB);
+    bind2(sets[SET_B_TO_A], workB, workA);
+    bind2(sets[SET_A_TO_HM], workA, hmBuf);
+    bind2(sets[SET_B_TO_HM], workB, hmBuf);
+
+    VkCommandBufferAllocateInfo cbAlloc{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+    cbAlloc.commandPool = cmdPool;
+    cbAlloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    cbAlloc.commandBufferCount = 1;
+    vkCheck(vkAllocateCommandBuffers(device, &cbAlloc, &cmd), "vkAllocateCommandBuffers(filters)");
+
+    // ---- batched recording ----
+    VkCommandBufferBeginInfo beginInfo{ VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &cmd;
+    uint32_t pending = 0;
+
+    auto flush = [&]() {
+        if (pending == 0) return;
+        vkCheck(vkEndCommandBuffer(cmd), "vkEndCommandBuffer(filters)");
+        vkCheck(vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE), "vkQueueSubmit(filters)");
+        vkCheck(vkQueueWaitIdle(queue), "vkQueueWaitIdle(filters)");
+        pending = 0;
+    };
+    auto dispatch = [&](VkPipeline pipe, VkDescriptorSet set, const void* pc, uint32_t pcBytes) {
+        if (pending == 0) {
+            vkCheck(vkResetCommandBuffer(cmd, 0), "vkResetCommandBuffer(filters)");
+            vkCheck(vkBeginCommandBuffer(cmd, &beginInfo), "vkBeginCommandBuffer(filters)");
+        } else { // previous pass wrote what this one reads
+            VkMemoryBarrier mb{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+            mb.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+            mb.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                                 0, 1, &mb, 0, nullptr, 0, nullptr);
+        }
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipe);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &set, 0, nullptr);
+        vkCmdPushConstants(cmd, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, pcBytes, pc);
+        vkCmdDispatch(cmd, (width + FILTER_GROUP - 1) / FILTER_GROUP, (height + FILTER_GROUP - 1) / FILTER_GROUP, 1);
+        if (++pending == DISPATCHES_PER_SUBMIT) flush();
+    };
+
+    // A -> B or B -> A, whichever way the data is
+    bool inA = true;
+    auto pingPong = [&](VkPipeline pipe, const void* pc, uint32_t pcBytes) {
+        dispatch(pipe, sets[inA ? SET_A_TO_B : SET_B_TO_A], pc, pcBytes);
+        inA = !inA;
+    };
+
+    // ---- 1) heightmap -> floats ----
+    PCConvert pcIn{ width, height, stride, 1 };
+    dispatch(pipeConvert, sets[SET_HM_TO_A], &pcIn, sizeof(pcIn));
+
+    // ---- 2) steps ----
+    for (const FilterStep& s : steps) {
+        if (s.kind == FilterKind::Smooth) {
+            TraceSpan stepSpan("filter_smooth");
+            for (uint32_t axis = 0; axis < 2; axis++) {
+                PCSmooth pc{ width, height, stride, s.amount, axis };
+                pingPong(pipeSmooth, &pc, sizeof(pc));
+            }
+            flush();
+        } else if (s.kind == FilterKind::Thermal) {
+            TraceSpan stepSpan("filter_thermal");
+            PCThermal pc{ width, height, stride, params.talus, params.thermalRate };
+            for (uint32_t i = 0; i < s.amount; i++) pingPong(pipeThermal, &pc, sizeof(pc));
+            flush();
+        } else {
+            TraceSpan stepSpan("filter_hydraulic");
+            for (uint32_t i = 0; i < s.amount; i++) {
+                const uint32_t phase = (i == 0 ? 1u : 0u) | (i + 1 == s.amount ? 2u : 0u);
+                PCHydraulic pc{ width, height, stride, phase,
+                                params.rain, params.capacity, params.erode, params.deposit };
+                pingPong(pipeHydraulic, &pc, sizeof(pc));
+            }
+            flush();
+        }
+    }
+
+    // ---- 3) floats -> heightmap ----
+    PCConvert pcOut{ width, height, stride, 0 };
+    dispatch(pipeConvert, sets[inA ? SET_A_TO_HM : SET_B_TO_HM], &pcOut, sizeof(pcOut));
+    flush();
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "vk_util.h"
+
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+terrain_filter.h
+
+Optional terrain prep inside build (--filter): smoothing and erosion on the heightmap while it sits in
+hmBuf, before any tile is cut. The whole map is filtered at once, so tiles still match at their borders
+and nothing goes back to the CPU. Heights are 0..1 floats while filtering (see filter_convert.comp).
+*/
+
+enum class FilterKind { Smooth, Thermal, Hydraulic };
+
+struct FilterStep {
+    FilterKind kind = FilterKind::Smooth;
+    uint32_t amount = 1; // smooth: blur radius in pixels (1..16). erosion: iterations
+};
+
+// knobs for the erosion steps. heights/talus are in 0..1 of the heightmap range
+struct TerrainFilterParams {
+    float talus = 0.004f;      // thermal: steepest drop to a neighbour that stays put
+    float thermalRate = 0.5f;  // thermal: share of the excess that slides per iteration
+    float rain = 0.0005f;      // hydraulic: water per pixel per iteration
+    float capacity = 0.5f;     // hydraulic: sediment per unit of moving water
+    float erode = 0.05f;       // hydraulic: how fast missing capacity is dug out
+    float deposit = 0.1f;      // hydraulic: how fast extra sediment settles
+};
+
+// "smooth:2,thermal:50,hydraulic:100" -> steps, run in that order
+std::vector<FilterStep> parseFilterSteps(const std::string& s);
+
+// run steps on hmBuf (width x height, one u16 height per uint) in place. cmdPool must be resettable.
+// setLayout/pipelineLayout are build's (2 storage buffers, 32 bytes of push constants)
+void runTerrainFilters(VkDevice device,
+                       VkPhysicalDevice physicalDevice,
+                       VkQueue queue,
+                       VkCommandPool cmdPool,
+                       VkDescriptorSetLayout setLayout,
+                       VkPipelineLayout pipelineLayout,
+                       const Buffer& hmBuf,
+                       uint32_t width,
+                       uint32_t height,
+                       const std::vector<FilterStep>& steps,
+                       const TerrainFilterParams& params);
@@ -0,0 +1,320 @@
+#include "terrain_reader.h"
+#include "heightmap_io.h"
+#include "minmax_index.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+terrain_reader.cpp
+
+1) constructor: scan tiles/ for tile_X_Y folders (map size), read the size of one lod0 file (tile size)
+   and count its lodN files (LOD count). The real map size comes from the minmax.index header
+2) MappedTile: one read only mapping of a lodN.height.raw
+3) TileCache: shard = mutex + LRU list + hash map. Files are mapped outside the lock so a slow disk
+   only blocks the threads that need that tile. Evicted tiles stay alive until their last reader lets go
+4) sample / sampleMany: world -> pixel, clamp, 4 heights (TileRef remembers the last tiles used), lerp
+*/
+
+//helpers
+// Parse "tile_X_Y" -> (X, Y). Returns false if format unexpected.
+static bool parseTileXY(const std::string& folderName, uint32_t& tx, uint32_t& ty) {
+    const std::string prefix = "tile_";
+    if (folderName.rfind(prefix, 0) != 0) return false;
+
+    size_t p1 = folderName.find('_', 5);
+    if (p1 == std::string::npos) return false;
+    try {
+        tx = static_cast<uint32_t>(std::stoul(folderName.substr(5, p1 - 5)));
+        ty = static_cast<uint32_t>(std::stoul(folderName.substr(p1 + 1)));
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+static std::string tilePath(const std::string& tilesDir, uint32_t tx, uint32_t ty, uint32_t lod) {
+    return tilesDir + "/tile_" + std::to_string(tx) + "_" + std::to_string(ty) + "/lod" + std::to_string(lod) + ".height.raw";
+}
+static uint64_t tileKey(uint32_t tx, uint32_t ty, uint32_t lod) {
+    return ((uint64_t)lod << 48) | ((uint64_t)ty << 24) | (uint64_t)tx;
+}
+
+// --- one mapped lodN.height.raw ---
+struct MappedTile {
+    const uint16_t* heights = nullptr;
+    size_t bytes = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+
+    MappedTile(const std::string& path, size_t expectBytes) {
+#ifdef _WIN32
+        file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) throw std::runtime_error("Failed to open: " + path);
+        LARGE_INTEGER size{};
+        if (!GetFileSizeEx(file, &size) || (size_t)size.QuadPart != expectBytes) {
+            CloseHandle(file);
+            throw std::runtime_error("Unexpected tile size: " + path);
+        }
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* p = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!p) {
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            throw std::runtime_error("Failed to map: " + path);
+        }
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Failed to open: " + path);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || (size_t)st.st_size != expectBytes) {
+            ::close(fd);
+            throw std::runtime_error("Unexpected tile size: " + path);
+        }
+        void* p = ::mmap(nullptr, expectBytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        if (p == MAP_FAILED) throw std::runtime_error("Failed to map: " + path);
+#endif
+        heights = static_cast<const uint16_t*>(p);
+        bytes = expectBytes;
+    }
+
+    ~MappedTile() {
+#ifdef _WIN32
+        UnmapViewOfFile(heights);
+        CloseHandle(mapping);
+        CloseHandle(file);
+#else
+        ::munmap(const_cast<uint16_t*>(heights), bytes);
+#endif
+    }
+
+    MappedTile(const MappedTile&) = delete;
+    MappedTile& operator=(const MappedTile&) = delete;
+};
+
+// --- sharded LRU of mapped tiles ---
+class TerrainReader::TileCache {
+public:
+    TileCache(size_t budgetBytes, uint32_t shardCount) : shards_(std::max(1u, shardCount)) {
+        shardBudget_ = budgetBytes / shards_.size();
+    }
+
+    std::shared_ptr<const MappedTile> get(uint64_t key, const std::string& path, size_t bytes) {
+        Shard& s = shards_[(size_t)((key * 0x9E3779B97F4A7C15ull) >> 40) % shards_.size()];
+        {
+            std::lock_guard<std::mutex> lk(s.m);
+            auto it = s.map.find(key);
+            if (it != s.map.end()) {
+                s.lru.splice(s.lru.begin(), s.lru, it->second.pos); // most recent at the front
+                hits_.fetch_add(1, std::memory_order_relaxed);
+                return it->second.tile;
+            }
+        }
+
+        // map outside the lock. if two threads race, the first one in keeps its mapping
+        auto tile = std::make_shared<const MappedTile>(path, bytes);
+        misses_.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lk(s.m);
+        auto it = s.map.find(key);
+        if (it != s.map.end()) return it->second.tile;
+
+        s.lru.push_front(key);
+        s.map.emplace(key, Entry{ tile, s.lru.begin() });
+        s.bytes += tile->bytes;
+        bytes_.fetch_add(tile->bytes, std::memory_order_relaxed);
+
+        //always keep the newest one, even if a single tile is over budget
+        while (s.bytes > shardBudget_ && s.lru.size() > 1) {
+            auto victim = s.map.find(s.lru.back());
+            s.bytes -= victim->second.tile->bytes;
+            bytes_.fetch_sub(victim->second.tile->bytes, std::memory_order_relaxed);
+            s.map.erase(victim);
+            s.lru.pop_back();
+            evictions_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return tile;
+    }
+
+    CacheStats stats() const {
+        CacheStats st;
+        st.hits = hits_.load(std::memory_order_relaxed);
+        st.misses = misses_.load(std::memory_order_relaxed);
+        st.evictions = evictions_.load(std::memory_order_relaxed);
+        st.bytes = bytes_.load(std::memory_order_relaxed);
+        return st;
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<const MappedTile> tile;
+        std::list<uint64_t>::iterator pos;
+    };
+    struct Shard {
+        std::mutex m;
+        std::list<uint64_t> lru;
+        std::unordered_map<uint64_t, Entry> map;
+        size_t bytes = 0;
+    };
+
+    std::vector<Shard> shards_;
+    size_t shardBudget_ = 0;
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<size_t> bytes_{0};
+};
+
+// last few tiles one sample/sampleMany call used. A bilinear footprint touches at most 4
+struct TileRef {
+    static constexpr int SLOTS = 4;
+    uint64_t keys[SLOTS] = { ~0ull, ~0ull, ~0ull, ~0ull };
+    std::shared_ptr<const MappedTile> tiles[SLOTS];
+    int next = 0;
+};
+
+// ---- 1) open ----
+TerrainReader::TerrainReader(const std::string& buildDir, const TerrainReaderOptions& options)
+    : tilesDir_(buildDir + "/tiles"), options_(options) {
+    if (!std::filesystem::exists(tilesDir_)) throw std::runtime_error("Tiles folder not found: " + tilesDir_);
+
+    bool any = false;
+    uint32_t firstX = 0, firstY = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(tilesDir_)) {
+        uint32_t tx = 0, ty = 0;
+        if (!entry.is_directory() || !parseTileXY(entry.path().filename().string(), tx, ty)) continue;
+        if (!any) { firstX = tx; firstY = ty; any = true; }
+        tilesX_ = std::max(tilesX_, tx + 1);
+        tilesY_ = std::max(tilesY_, ty + 1);
+    }
+    if (!any) throw std::runtime_error("No tiles in: " + tilesDir_);
+
+    const std::string lod0 = tilePath(tilesDir_, firstX, firstY, 0);
+    tileSize_ = rawTileSize(lod0);
+    if (tileSize_ == 0) throw std::runtime_error("Not a square u16 tile: " + lod0);
+
+    while ((tileSize_ >> lodCount_) > 0 && std::filesystem::exists(tilePath(tilesDir_, firstX, firstY, lodCount_)))
+        lodCount_++;
+
+    // edge tiles are padded up to the tile size, minmax.index knows where the heightmap really ends
+    mapWidth_ = tilesX_ * tileSize_;
+    mapHeight_ = tilesY_ * tileSize_;
+    const std::string indexPath = buildDir + "/minmax.index";
+    if (std::filesystem::exists(indexPath)) {
+        const MinMaxIndex header = readMinMaxIndexHeader(indexPath);
+        mapWidth_ = std::min(mapWidth_, header.mapWidth);
+        mapHeight_ = std::min(mapHeight_, header.mapHeight);
+    }
+
+    cache_ = std::make_unique<TileCache>(options_.cacheBytes, options_.shards);
+}
+
+TerrainReader::~TerrainReader() = default;
+
+TerrainReader::CacheStats TerrainReader::cacheStats() const {
+    return cache_->stats();
+}
+
+// ---- 4) sampling ----
+float TerrainReader::sample(float worldX, float worldZ, uint32_t lod) const {
+    float out = 0.0f;
+    sampleMany(&worldX, &worldZ, 1, lod, &out);
+    return out;
+}
+
+void TerrainReader::sampleMany(const float* worldX, const float* worldZ, size_t count, uint32_t lod, float* out) const {
+    if (lod >= lodCount_) throw std::runtime_error("TerrainReader: LOD " + std::to_string(lod) + " was not built.");
+
+    const uint32_t size = tileSize_ >> lod;                   // pixels per tile at this LOD
+    const uint32_t round = (1u << lod) - 1;                   // last LODn pixel with any real LOD0 pixel in it
+    const float maxX = float(((mapWidth_ + round) >> lod) - 1);
+    const float maxZ = float(((mapHeight_ + round) >> lod) - 1);
+    const float toPixel = 1.0f / (options_.spacing * float(1u << lod));
+    const float toHeight = options_.heightScale / 65535.0f;
+    const size_t tileBytes = (size_t)size * size * sizeof(uint16_t);
+
+    TileRef ref;
+    auto heightsOf = [&](uint32_t tx, uint32_t ty) -> const uint16_t* {
+        const uint64_t key = tileKey(tx, ty, lod);
+        for (int i = 0; i < TileRef::SLOTS; i++) {
+            if (ref.keys[i] == key) return ref.tiles[i]->heights;
+        }
+        const int slot = ref.next;
+        ref.next = (ref.next + 1) % TileRef::SLOTS;
+        ref.tiles[slot] = cache_->get(key, tilePath(tilesDir_, tx, ty, lod), tileBytes);
+        ref.keys[slot] = key;
+        return ref.tiles[slot]->heights;
+    };
+    auto heightAt = [&](uint32_t x, uint32_t z) -> uint16_t {
+        return heightsOf(x / size, z / size)[(size_t)(z % size) * size + (x % size)];
+    };
+
+    //blocks: pixel coords for the whole block first (plain float math the compiler can vectorize),
+    //then the gathers, then the lerps
+    constexpr size_t BLOCK = 256;
+    uint32_t px[BLOCK], pz[BLOCK];
+    float fx[BLOCK], fz[BLOCK];
+    float h00[BLOCK], h10[BLOCK], h01[BLOCK], h11[BLOCK];
+
+    for (size_t b = 0; b < count; b += BLOCK) {
+        const size_t n = std::min(BLOCK, count - b);
+
+        for (size_t i = 0; i < n; i++) {
+            const float x = std::clamp(worldX[b + i] * toPixel, 0.0f, maxX);
+            const float z = std::clamp(worldZ[b + i] * toPixel, 0.0f, maxZ);
+            const float x0 = std::floor(x);
+            const float z0 = std::floor(z);
+            px[i] = (uint32_t)x0;
+            pz[i] = (uint32_t)z0;
+            fx[i] = x - x0;
+            fz[i] = z - z0;
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            const uint32_t x0 = px[i], z0 = pz[i];
+            const uint32_t x1 = std::min(x0 + 1, (uint32_t)maxX);
+            const uint32_t z1 = std::min(z0 + 1, (uint32_t)maxZ);
+            if (x1 / size == x0 / size && z1 / size == z0 / size) { // same tile: one lookup for all 4
+                const uint16_t* t = heightsOf(x0 / size, z0 / size);
+                const uint32_t lx0 = x0 % size, lz0 = z0 % size;
+                const uint32_t lx1 = x1 % size, lz1 = z1 % size;
+                h00[i] = t[(size_t)lz0 * size + lx0];
+                h10[i] = t[(size_t)lz0 * size + lx1];
+                h01[i] = t[(size_t)lz1 * size + lx0];
+                h11[i] = t[(size_t)lz1 * size + lx1];
+            } else {
+                h00[i] = heightAt(x0, z0);
+                h10[i] = heightAt(x1, z0);
+                h01[i] = heightAt(x0, z1);
+                h11[i] = heightAt(x1, z1);
+            }
+        }
+
+        for (size_t i = 0; i < n; i++) {
+            const float top = h00[i] + (h10[i] - h00[i]) * fx[i];
+            const float bottom = h01[i] + (h11[i] - h01[i]) * fx[i];
+            out[b + i] = (top + (bottom - top) * fz[i]) * toHeight;
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/*
+terrain_reader.h
+
+Random access heights straight from a build output folder (tiles/tile_X_Y/lodN.height.raw),
+for code that links the library instead of running the exe (game servers, collision, tools).
+
+Tiles are memory mapped on first use and kept in a sharded LRU cache with a byte budget, so
+many threads can sample at once and only contend when they hit the same shard.
+
+World space matches export_mesh: pixel (x, z) of LOD0 sits at (x * spacing, z * spacing),
+LOD n pixels are 2^n times further apart, heights come back as h / 65535 * heightScale.
+Positions outside the map are clamped to its edge: the real heightmap size from minmax.index, so
+the padding build adds to edge tiles is never sampled (whole tiles when there is no index).
+A missing tile inside the map throws.
+*/
+
+struct TerrainReaderOptions {
+    size_t cacheBytes = size_t(256) << 20; // mapped tile bytes kept open, all shards together
+    uint32_t shards = 16;
+    float spacing = 1.0f;                  // export_mesh --spacing
+    float heightScale = 1.0f;              // export_mesh --scale
+};
+
+class TerrainReader {
+public:
+    // buildDir = the --out folder of build. Tile size, map size and LOD count come from the files
+    explicit TerrainReader(const std::string& buildDir, const TerrainReaderOptions& options = {});
+    ~TerrainReader();
+
+    TerrainReader(const TerrainReader&) = delete;
+    TerrainReader& operator=(const TerrainReader&) = delete;
+
+    uint32_t tileSize() const { return tileSize_; } // LOD0 pixels per tile side
+    uint32_t tilesX() const { return tilesX_; }
+    uint32_t tilesY() const { return tilesY_; }
+    uint32_t lodCount() const { return lodCount_; }
+    uint32_t mapWidth() const { return mapWidth_; }   // LOD0 pixels, tilesX * tileSize or less
+    uint32_t mapHeight() const { return mapHeight_; }
+
+    // bilinear height at a world position. thread safe
+    float sample(float worldX, float worldZ, uint32_t lod = 0) const;
+
+    // count samples, structure of arrays in and out. Nearby queries in a row reuse the same tiles
+    // without touching the cache, so sort or group them spatially for the best rate. thread safe
+    void sampleMany(const float* worldX, const float* worldZ, size_t count, uint32_t lod, float* out) const;
+
+    struct CacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        size_t bytes = 0; // currently mapped
+    };
+    CacheStats cacheStats() const;
+
+private:
+    class TileCache;
+
+    std::string tilesDir_;
+    TerrainReaderOptions options_;
+    uint32_t tileSize_ = 0;
+    uint32_t tilesX_ = 0;
+    uint32_t tilesY_ = 0;
+    uint32_t lodCount_ = 0;
+    uint32_t mapWidth_ = 0;
+    uint32_t mapHeight_ = 0;
+    std::unique_ptr<TileCache> cache_;
+};
@@ -0,0 +1,171 @@
+#include "trace.h"
+
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <vector>
+
+/*
+trace.cpp
+
+events are appended to one vector under a mutex and written as JSON by traceStop().
+tid 0 is the GPU track, CPU threads get 1, 2, 3 ... in the order they first emit
+*/
+
+std::atomic<bool> g_traceEnabled{false};
+
+namespace {
+struct TraceEvent {
+    char ph = 'X';            // X = complete span, C = counter, M = thread name
+    const char* name = nullptr;
+    uint32_t tid = 0;
+    uint64_t ts = 0;
+    uint64_t dur = 0;
+    int64_t value = 0;
+    TraceTile tile;
+};
+
+struct TraceState {
+    std::mutex m;
+    std::vector<TraceEvent> events;
+    std::set<std::string> names; // interned, node addresses are stable
+    std::string path;
+    std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+    std::atomic<uint32_t> nextTid{1};
+};
+
+TraceState& state() {
+    static TraceState s;
+    return s;
+}
+
+uint32_t threadId() {
+    thread_local uint32_t tid = state().nextTid.fetch_add(1);
+    return tid;
+}
+
+void push(const TraceEvent& e) {
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lk(s.m);
+    s.events.push_back(e);
+}
+
+void writeString(std::ofstream& o, const char* str) {
+    o << '"';
+    for (const char* p = str; *p; p++) {
+        if (*p == '"' || *p == '\\') o << '\\';
+        o << *p;
+    }
+    o << '"';
+}
+}
+
+uint64_t traceNowUs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - state().t0).count();
+}
+
+const char* traceIntern(const std::string& s) {
+    TraceState& st = state();
+    std::lock_guard<std::mutex> lk(st.m);
+    return st.names.insert(s).first->c_str();
+}
+
+void traceStart(const std::string& path) {
+    TraceState& s = state();
+    {
+        std::lock_guard<std::mutex> lk(s.m);
+        s.path = path;
+        s.events.clear();
+        s.events.reserve(1 << 16);
+        s.t0 = std::chrono::steady_clock::now();
+    }
+    TraceEvent gpu;
+    gpu.ph = 'M';
+    gpu.name = "GPU";
+    gpu.tid = 0;
+    push(gpu);
+    g_traceEnabled.store(true);
+    traceThreadName("main");
+}
+
+void traceThreadName(const char* name) {
+    if (!traceEnabled()) return;
+    TraceEvent e;
+    e.ph = 'M';
+    e.name = name;
+    e.tid = threadId();
+    push(e);
+}
+
+void traceComplete(const char* name, uint64_t startUs, uint64_t durUs, TraceTile tile) {
+    TraceEvent e;
+    e.name = name;
+    e.tid = threadId();
+    e.ts = startUs;
+    e.dur = durUs;
+    e.tile = tile;
+    push(e);
+}
+
+void traceGpu(const char* name, uint64_t startUs, uint64_t durUs, TraceTile tile) {
+    TraceEvent e;
+    e.name = name;
+    e.tid = 0;
+    e.ts = startUs;
+    e.dur = durUs;
+    e.tile = tile;
+    push(e);
+}
+
+void traceCounter(const char* name, int64_t value) {
+    TraceEvent e;
+    e.ph = 'C';
+    e.name = name;
+    e.tid = threadId();
+    e.ts = traceNowUs();
+    e.value = value;
+    push(e);
+}
+
+void traceStop() {
+    if (!traceEnabled()) return;
+    g_traceEnabled.store(false);
+
+    TraceState& s = state();
+    std::lock_guard<std::mutex> lk(s.m);
+    std::ofstream o(s.path);
+    if (!o) throw std::runtime_error("Failed to write: " + s.path);
+
+    o << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    for (size_t i = 0; i < s.events.size(); i++) {
+        const TraceEvent& e = s.events[i];
+        o << "{\"pid\":1,\"tid\":" << e.tid << ",\"ph\":\"" << e.ph << "\",";
+        if (e.ph == 'M') {
+            o << "\"name\":\"thread_name\",\"args\":{\"name\":";
+            writeString(o, e.name);
+            o << "}}";
+        } else if (e.ph == 'C') {
+            o << "\"name\":";
+            writeString(o, e.name);
+            o << ",\"ts\":" << e.ts << ",\"args\":{\"size\":" << e.value << "}}";
+        } else {
+            o << "\"name\":";
+            writeString(o, e.name);
+            o << ",\"cat\":\"" << (e.tid == 0 ? "gpu" : "cpu") << "\",\"ts\":" << e.ts << ",\"dur\":" << e.dur;
+            if (e.tile.x != UINT32_MAX || e.tile.lod != UINT32_MAX) {
+                o << ",\"args\":{";
+                bool first = true;
+                if (e.tile.x != UINT32_MAX) { o << "\"tileX\":" << e.tile.x << ",\"tileY\":" << e.tile.y; first = false; }
+                if (e.tile.lod != UINT32_MAX) o << (first ? "" : ",") << "\"lod\":" << e.tile.lod;
+                o << "}";
+            }
+            o << "}";
+        }
+        o << (i + 1 < s.events.size() ? ",\n" : "\n");
+    }
+    o << "]}\n";
+    s.events.clear();
+}
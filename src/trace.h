@@ -0,0 +1,54 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+/*
+trace.h  (--trace out.json)
+
+Chrome / Perfetto trace events. Open the file in ui.perfetto.dev or chrome://tracing.
+CPU spans per stage and tile, GPU dispatch durations (timestamp queries), and
+BoundedQueue occupancy + wait times.
+
+Nothing is recorded until traceStart(). While off, every call is one relaxed atomic load.
+Event names must outlive the trace: string literals, or traceIntern() for runtime names.
+*/
+
+extern std::atomic<bool> g_traceEnabled;
+inline bool traceEnabled() { return g_traceEnabled.load(std::memory_order_relaxed); }
+
+void traceStart(const std::string& path);
+void traceStop(); // writes the file given to traceStart
+
+uint64_t traceNowUs();
+const char* traceIntern(const std::string& s);
+void traceThreadName(const char* name); // label the calling thread's track
+
+// optional tile/LOD args shown on an event (UINT32_MAX = not set)
+struct TraceTile {
+    uint32_t x = UINT32_MAX;
+    uint32_t y = UINT32_MAX;
+    uint32_t lod = UINT32_MAX;
+};
+
+void traceComplete(const char* name, uint64_t startUs, uint64_t durUs, TraceTile tile = {});
+void traceGpu(const char* name, uint64_t startUs, uint64_t durUs, TraceTile tile = {}); // "GPU" track
+void traceCounter(const char* name, int64_t value);
+
+// RAII CPU span on the calling thread
+class TraceSpan {
+public:
+    explicit TraceSpan(const char* name, TraceTile tile = {})
+        : name_(name), tile_(tile), on_(traceEnabled()), start_(on_ ? traceNowUs() : 0) {}
+    ~TraceSpan() {
+        if (on_) traceComplete(name_, start_, traceNowUs() - start_, tile_);
+    }
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char* name_;
+    TraceTile tile_;
+    bool on_;
+    uint64_t start_;
+};
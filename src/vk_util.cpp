@@ -50,6 +50,11 @@ std::vector<char> readFile(const std::string& path) {
     return buffer;
 }
 
+//AURORA_SHADER_DIR comes from CMake (where glslc writes the .spv files)
+std::string shaderPath(const std::string& spvName) {
+    return std::string(AURORA_SHADER_DIR) + "/" + spvName;
+}
+
 //figure out mem type
  uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags props,
                               VkPhysicalDevice physicalDevice) {
@@ -152,7 +157,8 @@ VkDescriptorSetLayout makeSetLayout(VkDevice device) {
     VkPipeline makeComputePipeline(VkDevice device,
                                 VkPipelineLayout pipelineLayout,
                                 const std::string& spvPath,
-                                VkShaderModule* outModule) {
+                                VkShaderModule* outModule,
+                                const VkSpecializationInfo* spec) {
         auto code = readFile(spvPath);
 
         VkShaderModuleCreateInfo sm{VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
@@ -167,6 +173,7 @@ VkDescriptorSetLayout makeSetLayout(VkDevice device) {
         stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
         stage.module = module;
         stage.pName = "main";
+        stage.pSpecializationInfo = spec;
 
         VkComputePipelineCreateInfo cp{VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO};
         cp.stage = stage;
@@ -187,3 +194,86 @@ bool hasLayer(const std::vector<VkLayerProperties>& layers, const char* name) {
     }
     return false;
 }
+
+// --- steps 1-3 from the list at the top: instance, physical device, logical device + compute queue ---
+VulkanContext createVulkanContext(bool enableValidation) {
+    VulkanContext ctx{};
+
+    VkApplicationInfo app{VK_STRUCTURE_TYPE_APPLICATION_INFO};
+    app.pApplicationName = "AuroraTerrain";
+    app.apiVersion = VK_API_VERSION_1_2;
+
+    // Validation layer (just to help)
+    std::vector<const char*> enabledLayers;
+    if (enableValidation) {
+        uint32_t layerCount = 0;
+        vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
+        std::vector<VkLayerProperties> layers(layerCount);
+        vkEnumerateInstanceLayerProperties(&layerCount, layers.data());
+
+        const char* kValidation = "VK_LAYER_KHRONOS_validation";
+        if (hasLayer(layers, kValidation)) {
+            enabledLayers.push_back(kValidation);
+        } else {
+            std::cerr << "[Warn] Validation layer not found (ok, but debugging is harder).\n";
+        }
+    }
+
+    VkInstanceCreateInfo instInfo{VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+    instInfo.pApplicationInfo = &app;
+    instInfo.enabledLayerCount = static_cast<uint32_t>(enabledLayers.size());
+    instInfo.ppEnabledLayerNames = enabledLayers.empty() ? nullptr : enabledLayers.data();
+
+    vkCheck(vkCreateInstance(&instInfo, nullptr, &ctx.instance), "vkCreateInstance");
+
+    // find devices (and its info like queue)
+    uint32_t devCount = 0;
+    vkCheck(vkEnumeratePhysicalDevices(ctx.instance, &devCount, nullptr), "vkEnumeratePhysicalDevices(count)");
+    if (devCount == 0) {
+        vkDestroyInstance(ctx.instance, nullptr);
+        throw std::runtime_error("No Vulkan physical devices found.");
+    }
+    std::vector<VkPhysicalDevice> devs(devCount);
+    vkCheck(vkEnumeratePhysicalDevices(ctx.instance, &devCount, devs.data()), "vkEnumeratePhysicalDevices(list)");
+
+    for (auto d : devs) {
+        uint32_t qCount = 0;
+        vkGetPhysicalDeviceQueueFamilyProperties(d, &qCount, nullptr);
+        std::vector<VkQueueFamilyProperties> qProps(qCount);
+        vkGetPhysicalDeviceQueueFamilyProperties(d, &qCount, qProps.data());
+
+        for (uint32_t i = 0; i < qCount; i++) {
+            if (qProps[i].queueFlags & VK_QUEUE_COMPUTE_BIT) {
+                ctx.physicalDevice = d;
+                ctx.computeQueueFamily = i;
+                break;
+            }
+        }
+        if (ctx.physicalDevice) break;
+    }
+
+    if (!ctx.physicalDevice) {
+        vkDestroyInstance(ctx.instance, nullptr);
+        throw std::runtime_error("No compute-capable GPU found.");
+    }
+
+    float prio = 1.0f;
+    VkDeviceQueueCreateInfo qInfo{VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+    qInfo.queueFamilyIndex = ctx.computeQueueFamily;
+    qInfo.queueCount = 1;
+    qInfo.pQueuePriorities = &prio;
+
+    VkDeviceCreateInfo devInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+    devInfo.queueCreateInfoCount = 1;
+    devInfo.pQueueCreateInfos = &qInfo;
+
+    vkCheck(vkCreateDevice(ctx.physicalDevice, &devInfo, nullptr, &ctx.device), "vkCreateDevice");
+    vkGetDeviceQueue(ctx.device, ctx.computeQueueFamily, 0, &ctx.queue);
+    return ctx;
+}
+
+void destroyVulkanContext(VulkanContext& ctx) {
+    if (ctx.device) vkDestroyDevice(ctx.device, nullptr);
+    if (ctx.instance) vkDestroyInstance(ctx.instance, nullptr);
+    ctx = VulkanContext{};
+}
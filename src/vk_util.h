@@ -18,6 +18,9 @@ Buffer createBuffer(VkDevice device,
 void vkCheck(VkResult r, const char* msg);
 std::vector<char> readFile(const std::string& path);
 
+// full path of a compiled shader ("extract_tile.comp.spv"); CMake compiles them into build/shaders
+std::string shaderPath(const std::string& spvName);
+
 uint32_t findMemoryType(uint32_t typeFilter,
                         VkMemoryPropertyFlags props,
                         VkPhysicalDevice physicalDevice);
@@ -28,9 +31,23 @@ VkPipelineLayout makePipelineLayout(VkDevice device,
                                     VkDescriptorSetLayout setLayout,
                                     uint32_t pushConstantBytes);
 
+// spec (optional) sets the shader's specialization constants (layout(constant_id = N))
 VkPipeline makeComputePipeline(VkDevice device,
                                VkPipelineLayout pipelineLayout,
                                const std::string& spvPath,
-                               VkShaderModule* outModule);
+                               VkShaderModule* outModule,
+                               const VkSpecializationInfo* spec = nullptr);
 
 bool hasLayer(const std::vector<VkLayerProperties>& layers, const char* name);
+
+// instance + first compute capable device + one compute queue (main and the bench share this)
+struct VulkanContext {
+    VkInstance instance = VK_NULL_HANDLE;
+    VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkDevice device = VK_NULL_HANDLE;
+    VkQueue queue = VK_NULL_HANDLE;
+    uint32_t computeQueueFamily = UINT32_MAX;
+};
+
+VulkanContext createVulkanContext(bool enableValidation);
+void destroyVulkanContext(VulkanContext& ctx);